@@ -2,49 +2,29 @@
 
 namespace tdenum {
 
-BlockInfo::BlockInfo(const Graph& setG, BlockPtr setB) :
-	B(*setB), GinducedB(setG, setB->nodes),locBySize(-1) { }
-
-BlockInfo::BlockInfo(const SubGraph& setG, BlockPtr setB) :
-	B(*setB), GinducedB(setG, setB->nodes), locBySize(-1){}
-
-int BlockInfo::blockSize() const {
-	return B.nodes.size();
+const NodeSet& BlockTable::pmc(int entry) const {
+	return *(pmcs.begin() + pmcIDs[entry]);
 }
 
-bool BlockInfo::isS(const MinimalSeparator& ms) {
-	return B.S == ms;
+BlockIDRange BlockTable::subBlocks(int entry) const {
+	const int* ids = subBlockIDs.data();
+	return BlockIDRange(ids + subBlockOffsets[entry], ids + subBlockOffsets[entry+1]);
 }
 
-bool BlockInfo::isC(const NodeSet& ns) {
-	return B.C == ns;
+int BlockTable::findEntry(int i, const NodeSet* pmc) const {
+	for (int entry = firstEntry(i); entry < endEntry(i); entry++)
+		if (&this->pmc(entry) == pmc)
+			return entry;
+	return -1;
 }
 
-void BlockInfo::updatePMCs(NodeSetSet& pmcList) {
-	for (auto pmc = pmcList.begin(); pmc != pmcList.end(); pmc++)
-		if (B.includesNodes(*pmc))
-			pmcToBlocks[*pmc] = vector<int>();
+void BlockTable::clear() {
+	blocks.clear();
+	pmcs.clear();
+	pmcOffsets.clear();
+	pmcIDs.clear();
+	subBlockOffsets.clear();
+	subBlockIDs.clear();
 }
 
-void BlockInfo::updateLocation(int i, SepToBlockMap& SToB) {
-	locBySize = i;
-
-	// For each pmc associated with our current block, and its block list (pmcToB)
-	for (auto pmcToB = pmcToBlocks.begin(); pmcToB != pmcToBlocks.end(); pmcToB++) {
-		// Calculate all PMC blocks
-		BlockVec pmcBlocks = GinducedB.getBlocksByMain(pmcToB->first);
-		// For each block (pmcBlock) of the PMC
-		for (auto pmcBlock = pmcBlocks.begin(); pmcBlock != pmcBlocks.end(); pmcBlock++)
-			// For each BlockInfo associated  with pmcBlock's separator (sepBlockInfo)
-			for (auto sepBlockInfo = SToB[(*pmcBlock)->S].begin(); 
-				sepBlockInfo != SToB[(*pmcBlock)->S].end(); sepBlockInfo++)
-				// If sepBlockInfo.B is the same block as pmcBlock
-				if ((*sepBlockInfo)->isC((*pmcBlock)->C)) {
-					// Update its location in pmcToBlocks
-					pmcToB->second.push_back((*sepBlockInfo)->locBySize);
-					break;
-				}
-	}
 }
-
-}
\ No newline at end of file
@@ -2,50 +2,52 @@
 #define BLOCKINFO_H
 
 #include "Graph.h"
-#include "SubGraph.h"
 #include "DataStructures.h"
-//#include "TriangulationEvaluator.h"
 #include <vector>
 #include <map>
 
 namespace tdenum {
 	/**
-	* TODO - write documentation
+	* The full blocks of a graph and their PMCs, stored flat.
+	* Blocks are referenced by their location in the table, and each PMC is
+	* stored once and referenced by its id (its index in the PMC set).
+	* The PMCs of block i are the entries pmcOffsets[i],...,pmcOffsets[i+1]-1
+	* of pmcIDs (in ascending order of the PMCs), and the sub blocks of entry
+	* j are subBlockIDs[subBlockOffsets[j]],...,subBlockIDs[subBlockOffsets[j+1]-1].
 	*/
-	class BlockInfo {
+	class BlockTable {
 		friend class OptimalMinimalTriangulator;
 
-		// The current block (S,C)
-		const Block B;
-		// SubGraph of the original graph, induced by block nodes
-		const SubGraph GinducedB;
-		// Location of block in list of graph blocks
-		int locBySize;
-		// Map each PMC such that S subset PMC subseteq S,C for this block
-		// To the location of each of its blocks in the block list
-		map<NodeSet, vector<int>> pmcToBlocks;
+		vector<Block> blocks;
+		NodeSetSet pmcs;
+		vector<int> pmcOffsets;
+		vector<int> pmcIDs;
+		vector<int> subBlockOffsets;
+		vector<int> subBlockIDs;
 
 	public:
-		typedef map<MinimalSeparator, vector<BlockInfo*>> SepToBlockMap;
+		BlockTable() {}
 
-		BlockInfo(const Graph& originalG, BlockPtr setB);
-		BlockInfo(const SubGraph& originalG, BlockPtr setB);
+		int size() const { return blocks.size(); }
+		const Block& block(int i) const { return blocks[i]; }
 
-		int blockSize() const;
-		int getLocation() { return locBySize; }
+		// The range of entries of block i
+		int firstEntry(int i) const { return pmcOffsets[i]; }
+		int endEntry(int i) const { return pmcOffsets[i+1]; }
 
-		bool isS(const MinimalSeparator&);
-		bool isC(const NodeSet&);
+		// The PMC of the given entry, and the locations of its sub blocks
+		const NodeSet& pmc(int entry) const;
+		BlockIDRange subBlocks(int entry) const;
 
-		// Insert only relevant PMCs into pmcToBlocks
-		void updatePMCs(NodeSetSet& pmc_list);
-
-		// Update my location and location of each PMC's blocks
-		void updateLocation(int i, SepToBlockMap& SToB);
+		// The entry of block i holding the given PMC (compared by address),
+		// or -1.
+		int findEntry(int i, const NodeSet* pmc) const;
 
+		void clear();
 	};
 
-	typedef map<MinimalSeparator, vector<BlockInfo*>> SepToBlockMap;
+	// Maps each minimal separator to the locations of its full blocks
+	typedef map<MinimalSeparator, vector<int>> SepToBlockMap;
 
 } /* namespace tdenum */
 
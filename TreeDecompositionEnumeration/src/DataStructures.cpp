@@ -6,74 +6,231 @@
  */
 
 #include "DataStructures.h"
+#include "Utils.h"
 #include <sstream>
 
 namespace tdenum {
 
 IncreasingWeightNodeQueue::IncreasingWeightNodeQueue(int numberOfNodes) :
-		weight(numberOfNodes, 0) {
-	vector< pair<int,Node> > temporaryQueue;
+		weight(numberOfNodes, 0), buckets(1), bucketSizes(1, numberOfNodes), maxWeight(0),
+		numberOfNodesLeft(numberOfNodes) {
+	buckets[0].reserve(numberOfNodes);
 	for (Node v = 0; v<numberOfNodes; v++) {
-		temporaryQueue.push_back(pair<int,Node> (0,v));
+		buckets[0].push_back(v);
 	}
-	queue = set< pair<int,Node> >(temporaryQueue.begin(), temporaryQueue.end());
+	make_heap(buckets[0].begin(), buckets[0].end());
 }
 void IncreasingWeightNodeQueue::increaseWeight(Node v) {
-	queue.erase(pair<int,Node> (weight[v],v));
+	bucketSizes[weight[v]]--;
 	weight[v]++;
-	queue.insert(pair<int,Node> (weight[v],v));
+	if (weight[v] == (int)buckets.size()) {
+		buckets.push_back(vector<Node>());
+		bucketSizes.push_back(0);
+	}
+	buckets[weight[v]].push_back(v);
+	push_heap(buckets[weight[v]].begin(), buckets[weight[v]].end());
+	bucketSizes[weight[v]]++;
+	if (weight[v] > maxWeight) {
+		maxWeight = weight[v];
+	}
 }
 int IncreasingWeightNodeQueue::getWeight(Node v) {
 	return weight[v];
 }
 bool IncreasingWeightNodeQueue::isEmpty() {
-	return queue.empty();
+	return numberOfNodesLeft == 0;
 }
 Node IncreasingWeightNodeQueue::pop() {
-	pair<int,Node> current = *queue.rbegin();
-	Node v = current.second;
-	queue.erase(current);
+	while (bucketSizes[maxWeight] == 0) {
+		buckets[maxWeight].clear();
+		maxWeight--;
+	}
+	vector<Node>& bucket = buckets[maxWeight];
+	// Skip the nodes that moved to another bucket
+	while (weight[bucket.front()] != maxWeight) {
+		pop_heap(bucket.begin(), bucket.end());
+		bucket.pop_back();
+	}
+	Node v = bucket.front();
+	pop_heap(bucket.begin(), bucket.end());
+	bucket.pop_back();
+	bucketSizes[maxWeight]--;
+	numberOfNodesLeft--;
 	return v;
 }
 
-bool WeightedNodeSetQueue::isEmpty() {
+IndexedNodeHeap::IndexedNodeHeap(int numberOfNodes) :
+		keys(numberOfNodes, 0), positions(numberOfNodes, -1) {
+	heap.reserve(numberOfNodes);
+}
+bool IndexedNodeHeap::isBefore(int i, int j) const {
+	Node u = heap[i];
+	Node v = heap[j];
+	return keys[u] < keys[v] || (keys[u] == keys[v] && u < v);
+}
+void IndexedNodeHeap::swapEntries(int i, int j) {
+	swap(heap[i], heap[j]);
+	positions[heap[i]] = i;
+	positions[heap[j]] = j;
+}
+void IndexedNodeHeap::siftUp(int i) {
+	while (i > 0 && isBefore(i, (i-1)/2)) {
+		swapEntries(i, (i-1)/2);
+		i = (i-1)/2;
+	}
+}
+void IndexedNodeHeap::siftDown(int i) {
+	int size = heap.size();
+	while (true) {
+		int smallest = i;
+		int left = 2*i + 1;
+		int right = left + 1;
+		if (left < size && isBefore(left, smallest)) {
+			smallest = left;
+		}
+		if (right < size && isBefore(right, smallest)) {
+			smallest = right;
+		}
+		if (smallest == i) {
+			return;
+		}
+		swapEntries(i, smallest);
+		i = smallest;
+	}
+}
+void IndexedNodeHeap::push(Node v, int key) {
+	keys[v] = key;
+	positions[v] = heap.size();
+	heap.push_back(v);
+	siftUp(positions[v]);
+}
+void IndexedNodeHeap::update(Node v, int key) {
+	int oldKey = keys[v];
+	keys[v] = key;
+	if (key < oldKey) {
+		siftUp(positions[v]);
+	} else {
+		siftDown(positions[v]);
+	}
+}
+Node IndexedNodeHeap::pop() {
+	Node v = heap.front();
+	swapEntries(0, heap.size()-1);
+	heap.pop_back();
+	positions[v] = -1;
+	if (!heap.empty()) {
+		siftDown(0);
+	}
+	return v;
+}
+
+template<class SetType>
+bool BasicWeightedNodeSetQueue<SetType>::isEmpty() {
 	return queue.empty();
 }
-bool WeightedNodeSetQueue::isMember(const vector<Node>& nodeVec, int weight) {
+template<class SetType>
+bool BasicWeightedNodeSetQueue<SetType>::isMember(const SetType& nodeVec, int weight) {
 	return queue.find(make_pair(weight, nodeVec)) != queue.end();
 }
-void WeightedNodeSetQueue::insert(const vector<Node>& nodeVec, int weight) {
+template<class SetType>
+void BasicWeightedNodeSetQueue<SetType>::insert(const SetType& nodeVec, int weight) {
 	queue.insert(make_pair(weight, nodeVec));
 }
-vector<Node> WeightedNodeSetQueue::pop() {
-	vector<Node> nodeVec = queue.begin()->second;
+template<class SetType>
+SetType BasicWeightedNodeSetQueue<SetType>::pop() {
+	SetType nodeVec = queue.begin()->second;
 	queue.erase(queue.begin());
 	return nodeVec;
 }
 
-NodeSetSet::NodeSetSet(const set<NodeSet>& s) : sets(s) {}
-bool NodeSetSet::isMember(const vector<Node>& nodeVec) const {
-	return sets.find(nodeVec) != sets.end();
+template<class SetType>
+BasicNodeSetSet<SetType>::BasicNodeSetSet(const set<SetType>& s) {
+	for (auto it = s.begin(); it != s.end(); ++it) {
+		insert(*it);
+	}
+}
+template<class SetType>
+unsigned int BasicNodeSetSet<SetType>::findSlot(const SetType& nodeSet,
+												unsigned long long fingerprint) const {
+	unsigned int slot = fingerprint & slotMask();
+	while (table[slot] != EMPTY_SLOT) {
+		if (fingerprints[table[slot]] == fingerprint && sets[table[slot]] == nodeSet) {
+			break;
+		}
+		slot = (slot + 1) & slotMask();
+	}
+	return slot;
+}
+template<class SetType>
+unsigned int BasicNodeSetSet<SetType>::findIndexSlot(int index) const {
+	unsigned int slot = fingerprints[index] & slotMask();
+	while (table[slot] != index) {
+		slot = (slot + 1) & slotMask();
+	}
+	return slot;
+}
+// Empties the slot, and shifts back any later entry of the probe sequence
+// that would otherwise become unreachable.
+template<class SetType>
+void BasicNodeSetSet<SetType>::eraseSlot(unsigned int slot) {
+	unsigned int next = slot;
+	while (true) {
+		next = (next + 1) & slotMask();
+		if (table[next] == EMPTY_SLOT) {
+			break;
+		}
+		unsigned int home = fingerprints[table[next]] & slotMask();
+		// Move the entry if its home slot isn't cyclically in (slot,next]
+		bool homeInRange = (slot <= next) ? (slot < home && home <= next)
+										  : (slot < home || home <= next);
+		if (!homeInRange) {
+			table[slot] = table[next];
+			slot = next;
+		}
+	}
+	table[slot] = EMPTY_SLOT;
+}
+template<class SetType>
+void BasicNodeSetSet<SetType>::rehash(unsigned int tableSize) {
+	table.assign(tableSize, EMPTY_SLOT);
+	for (unsigned int i=0; i<sets.size(); ++i) {
+		unsigned int slot = fingerprints[i] & slotMask();
+		while (table[slot] != EMPTY_SLOT) {
+			slot = (slot + 1) & slotMask();
+		}
+		table[slot] = i;
+	}
+}
+template<class SetType>
+bool BasicNodeSetSet<SetType>::isMember(const SetType& nodeVec) const {
+	return find(nodeVec) != end();
+}
+template<class SetType>
+vector<SetType> BasicNodeSetSet<SetType>::sorted() const {
+	vector<SetType> result(sets);
+	std::sort(result.begin(), result.end());
+	return result;
 }
-string NodeSetSet::str() const {
+template<class SetType>
+string BasicNodeSetSet<SetType>::str() const {
     if (empty()) {
         return string("{}");
     }
+    vector<SetType> ordered = sorted();
     ostringstream oss;
     oss << "\{ ";
-    for(auto it = begin(); it != end(); ++it) {
-		if (it != begin())
+    for(auto it = ordered.begin(); it != ordered.end(); ++it) {
+		if (it != ordered.begin())
 			oss << ",";
-		if (it->size() == 0) {
+		const NodeSet& ns = to_nodeset(*it);
+		if (ns.size() == 0) {
             oss << "\{}";
             continue;
         }
-        // *it is now a NodeSet.
-        // There's no way to print a NodeSet unless we know it's a vector...
         oss << "\{";
-        for(unsigned int j = 0; j < it->size(); ++j) {
-            oss << (*it)[j];
-			if (j + 1 < it->size())
+        for(unsigned int j = 0; j < ns.size(); ++j) {
+            oss << ns[j];
+			if (j + 1 < ns.size())
 				oss << ",";
         }
         oss << "}";
@@ -81,47 +238,320 @@ string NodeSetSet::str() const {
     oss << "}";
     return oss.str();
 }
-ostream& operator<<(ostream& os, const NodeSetSet& nss) {
-    os << nss.str();
-    return os;
-}
-void NodeSetSet::insert(const NodeSet& nodeVec) {
-	sets.insert(nodeVec);
+template<class SetType>
+void BasicNodeSetSet<SetType>::insert(const SetType& nodeVec) {
+	if (2*(sets.size()+1) > table.size()) {
+		rehash(table.empty() ? 16 : 2*table.size());
+	}
+	unsigned long long fingerprint = nodeset_hash(nodeVec);
+	unsigned int slot = findSlot(nodeVec, fingerprint);
+	if (table[slot] != EMPTY_SLOT) {
+		return;
+	}
+	table[slot] = sets.size();
+	sets.push_back(nodeVec);
+	fingerprints.push_back(fingerprint);
 }
-void NodeSetSet::remove(const NodeSet& nodeVec) {
-    sets.erase(nodeVec);
+// The last node set takes the place of the removed one
+template<class SetType>
+void BasicNodeSetSet<SetType>::remove(const SetType& nodeVec) {
+	if (sets.empty()) {
+		return;
+	}
+	unsigned int slot = findSlot(nodeVec, nodeset_hash(nodeVec));
+	int index = table[slot];
+	if (index == EMPTY_SLOT) {
+		return;
+	}
+	eraseSlot(slot);
+	int last = sets.size() - 1;
+	if (index != last) {
+		table[findIndexSlot(last)] = index;
+		sets[index] = sets[last];
+		fingerprints[index] = fingerprints[last];
+	}
+	sets.pop_back();
+	fingerprints.pop_back();
 }
-NodeSetSet NodeSetSet::unify(const NodeSetSet& other) const {
-	NodeSetSet result = other;
+template<class SetType>
+BasicNodeSetSet<SetType> BasicNodeSetSet<SetType>::unify(const BasicNodeSetSet& other) const {
+	BasicNodeSetSet result = other;
 	for (auto ns = begin(); ns != end(); ns++)
 		result.insert(*ns);
 	return result;
 }
-bool NodeSetSet::operator==(const NodeSetSet& nss) const {
-    return sets == nss.sets;
+template<class SetType>
+bool BasicNodeSetSet<SetType>::operator==(const BasicNodeSetSet& nss) const {
+	if (size() != nss.size()) {
+		return false;
+	}
+	for (auto ns = begin(); ns != end(); ns++) {
+		if (!nss.isMember(*ns))
+			return false;
+	}
+	return true;
 }
-bool NodeSetSet::operator!=(const NodeSetSet& nss) const {
+template<class SetType>
+bool BasicNodeSetSet<SetType>::operator!=(const BasicNodeSetSet& nss) const {
     return !(*this == nss);
 }
-unsigned int NodeSetSet::size() const {
+template<class SetType>
+unsigned int BasicNodeSetSet<SetType>::size() const {
     return sets.size();
 }
-bool NodeSetSet::empty() const {
+template<class SetType>
+bool BasicNodeSetSet<SetType>::empty() const {
     return sets.empty();
 }
-void NodeSetSet::clear() {
+template<class SetType>
+void BasicNodeSetSet<SetType>::clear() {
     sets.clear();
+    fingerprints.clear();
+    table.clear();
 }
-set<NodeSet>::iterator NodeSetSet::begin() const {
+template<class SetType>
+void BasicNodeSetSet<SetType>::swap(BasicNodeSetSet& other) {
+    sets.swap(other.sets);
+    fingerprints.swap(other.fingerprints);
+    table.swap(other.table);
+}
+template<class SetType>
+typename BasicNodeSetSet<SetType>::iterator BasicNodeSetSet<SetType>::begin() const {
     return sets.begin();
 }
-set<NodeSet>::iterator NodeSetSet::end() const {
+template<class SetType>
+typename BasicNodeSetSet<SetType>::iterator BasicNodeSetSet<SetType>::end() const {
     return sets.end();
 }
-set<NodeSet>::iterator NodeSetSet::find(const NodeSet& nodeSet) const {
-    return sets.find(nodeSet);
+template<class SetType>
+typename BasicNodeSetSet<SetType>::iterator BasicNodeSetSet<SetType>::find(const SetType& nodeSet) const {
+	if (sets.empty()) {
+		return end();
+	}
+	int index = table[findSlot(nodeSet, nodeset_hash(nodeSet))];
+	return index == EMPTY_SLOT ? end() : begin() + index;
+}
+
+
+
+void bitwords_to_nodeset(const BitWord* words, int numWords, NodeSet& out) {
+	for (int i=0; i<numWords; ++i) {
+		BitWord w = words[i];
+		while (w) {
+			out.push_back(i*BITWORD_BITS + bitword_lowest(w));
+			w &= w-1;
+		}
+	}
+}
+
+bool bitwords_less(const BitWord* a, int na, const BitWord* b, int nb) {
+	int n = max(na, nb);
+	for (int i=0; i<n; ++i) {
+		BitWord x = (i < na ? a[i] : 0);
+		BitWord y = (i < nb ? b[i] : 0);
+		if (x == y) {
+			continue;
+		}
+		// The smallest node in exactly one of the sets decides: the set
+		// holding it is smaller unless the other set ends before it.
+		BitWord lowest = (x ^ y) & (~(x ^ y) + 1);
+		BitWord above = ~(lowest | (lowest - 1));
+		const BitWord* other = (x & lowest) ? b : a;
+		int otherWords = (x & lowest) ? nb : na;
+		bool otherContinues = ((x & lowest) ? (y & above) : (x & above)) != 0;
+		for (int j=i+1; !otherContinues && j<otherWords; ++j) {
+			otherContinues = (other[j] != 0);
+		}
+		return (x & lowest) ? otherContinues : !otherContinues;
+	}
+	return false;
 }
 
+void bitset_capacity_error(Node v, int capacity) {
+	TRACE(TRACE_LVL__ERROR, "Node " << v << " doesn't fit in a bitset of "
+			<< capacity << " nodes, ignoring it");
+}
+
+// Spreads the bits of a hash, so the low bits can be used as a table index
+static inline unsigned long long hash_finalize(unsigned long long h) {
+	h ^= h >> 33;
+	h *= 0xff51afd7ed558ccdULL;
+	h ^= h >> 33;
+	return h;
+}
+
+// Trailing zero words are ignored, so sets of different widths holding the
+// same nodes have the same hash.
+size_t bitwords_hash(const BitWord* words, int numWords) {
+	while (numWords > 0 && words[numWords-1] == 0) {
+		numWords--;
+	}
+	unsigned long long h = 1469598103934665603ULL;
+	for (int i=0; i<numWords; ++i) {
+		h ^= words[i];
+		h *= 1099511628211ULL;
+		h ^= h >> 29;
+	}
+	return size_t(hash_finalize(h));
+}
+
+size_t nodeset_hash(const NodeSet& nodes) {
+	unsigned long long h = 1469598103934665603ULL;
+	for (Node v : nodes) {
+		h ^= (unsigned long long)v;
+		h *= 1099511628211ULL;
+	}
+	return size_t(hash_finalize(h));
+}
+
+NodeBitSet<0>::NodeBitSet(const NodeSet& nodes) {
+	for (Node v : nodes) {
+		insert(v);
+	}
+}
+NodeBitSet<0>::NodeBitSet(const BitWord* row, int numWords) : words(row, row+numWords) {
+	trim();
+}
+void NodeBitSet<0>::insert(Node v) {
+	if (BITWORD_INDEX(v) >= int(words.size())) {
+		words.resize(BITWORD_INDEX(v)+1, 0);
+	}
+	words[BITWORD_INDEX(v)] |= BITWORD_MASK(v);
+}
+void NodeBitSet<0>::remove(Node v) {
+	if (BITWORD_INDEX(v) < int(words.size())) {
+		words[BITWORD_INDEX(v)] &= ~BITWORD_MASK(v);
+		trim();
+	}
+}
+int NodeBitSet<0>::size() const {
+	int count = 0;
+	for (BitWord w : words) {
+		count += bitword_count(w);
+	}
+	return count;
+}
+bool NodeBitSet<0>::isSubsetOf(const NodeBitSet& other) const {
+	if (words.size() > other.words.size()) {
+		return false;
+	}
+	for (unsigned i=0; i<words.size(); ++i) {
+		if (words[i] & ~other.words[i])
+			return false;
+	}
+	return true;
+}
+bool NodeBitSet<0>::intersects(const NodeBitSet& other) const {
+	unsigned n = min(words.size(), other.words.size());
+	for (unsigned i=0; i<n; ++i) {
+		if (words[i] & other.words[i])
+			return true;
+	}
+	return false;
+}
+NodeBitSet<0>& NodeBitSet<0>::operator|=(const NodeBitSet& other) {
+	if (other.words.size() > words.size()) {
+		words.resize(other.words.size(), 0);
+	}
+	for (unsigned i=0; i<other.words.size(); ++i) {
+		words[i] |= other.words[i];
+	}
+	return *this;
+}
+NodeBitSet<0>& NodeBitSet<0>::operator&=(const NodeBitSet& other) {
+	if (words.size() > other.words.size()) {
+		words.resize(other.words.size());
+	}
+	for (unsigned i=0; i<words.size(); ++i) {
+		words[i] &= other.words[i];
+	}
+	trim();
+	return *this;
+}
+NodeBitSet<0>& NodeBitSet<0>::operator-=(const NodeBitSet& other) {
+	unsigned n = min(words.size(), other.words.size());
+	for (unsigned i=0; i<n; ++i) {
+		words[i] &= ~other.words[i];
+	}
+	trim();
+	return *this;
+}
+NodeSet NodeBitSet<0>::toNodeSet() const {
+	NodeSet result;
+	bitwords_to_nodeset(words.data(), words.size(), result);
+	return result;
+}
+
+/*
+ * Row kernels. W is the row width in words; W=0 means the width is only known
+ * at runtime (passed as n).
+ */
+template<int W>
+static inline void bitwords_or(BitWord* out, const BitWord* in, int n) {
+	const int width = W ? W : n;
+	for (int i=0; i<width; ++i) {
+		out[i] |= in[i];
+	}
+}
+template<int W>
+static inline bool bitwords_intersect(const BitWord* a, const BitWord* b, int n) {
+	const int width = W ? W : n;
+	for (int i=0; i<width; ++i) {
+		if (a[i] & b[i])
+			return true;
+	}
+	return false;
+}
+template<int W>
+static void bitwords_or_rows(const BitWord* rows, const Node* first, const Node* last,
+							BitWord* out, int n) {
+	const int width = W ? W : n;
+	for (; first != last; ++first) {
+		bitwords_or<W>(out, rows + (*first)*width, n);
+	}
+}
+
+AdjacencyMatrix::AdjacencyMatrix(int n) : numberOfNodes(0), wordsPerRow(0) {
+	reset(n);
+}
+int AdjacencyMatrix::rowWidth(int n) {
+	int words = BITWORDS_FOR(n);
+	if (words <= 1) return 1;
+	if (words <= 2) return 2;
+	if (words <= 4) return 4;
+	return words;
+}
+void AdjacencyMatrix::reset(int n) {
+	numberOfNodes = n;
+	wordsPerRow = rowWidth(n);
+	rows.assign(size_t(n)*wordsPerRow, 0);
+}
+void AdjacencyMatrix::orRow(Node v, BitWord* out) const {
+	switch (wordsPerRow) {
+	case 1: bitwords_or<1>(out, row(v), 1); break;
+	case 2: bitwords_or<2>(out, row(v), 2); break;
+	case 4: bitwords_or<4>(out, row(v), 4); break;
+	default: bitwords_or<0>(out, row(v), wordsPerRow); break;
+	}
+}
+void AdjacencyMatrix::orRows(const Node* first, const Node* last, BitWord* out) const {
+	if (first == last)
+		return;
+	switch (wordsPerRow) {
+	case 1: bitwords_or_rows<1>(rows.data(), first, last, out, 1); break;
+	case 2: bitwords_or_rows<2>(rows.data(), first, last, out, 2); break;
+	case 4: bitwords_or_rows<4>(rows.data(), first, last, out, 4); break;
+	default: bitwords_or_rows<0>(rows.data(), first, last, out, wordsPerRow); break;
+	}
+}
+bool AdjacencyMatrix::rowIntersects(Node v, const BitWord* words) const {
+	switch (wordsPerRow) {
+	case 1: return bitwords_intersect<1>(row(v), words, 1);
+	case 2: return bitwords_intersect<2>(row(v), words, 2);
+	case 4: return bitwords_intersect<4>(row(v), words, 4);
+	default: return bitwords_intersect<0>(row(v), words, wordsPerRow);
+	}
+}
 
 
 NodeSetProducer::NodeSetProducer(int sizeOfOriginalNodeSet) :
@@ -149,4 +579,75 @@ NodeSet NodeSetProducer::produce() {
 	return members;
 }
 
+NodeSetFileWriter::NodeSetFileWriter(const string& filename) :
+		out(filename.c_str(), ios::out | ios::binary | ios::trunc), count(0) {}
+bool NodeSetFileWriter::isOpen() const {
+	return out.is_open();
+}
+void NodeSetFileWriter::writeNumber(unsigned int x) {
+	while (x >= 0x80) {
+		out.put(char((x & 0x7F) | 0x80));
+		x >>= 7;
+	}
+	out.put(char(x));
+}
+void NodeSetFileWriter::write(const NodeSet& nodeSet) {
+	writeNumber(nodeSet.size());
+	for (unsigned int i=0; i<nodeSet.size(); ++i) {
+		writeNumber(i == 0 ? nodeSet[0] : nodeSet[i] - nodeSet[i-1] - 1);
+	}
+	count++;
+}
+long NodeSetFileWriter::getCount() const {
+	return count;
+}
+void NodeSetFileWriter::close() {
+	out.close();
+}
+
+NodeSetFileReader::NodeSetFileReader(const string& filename) :
+		in(filename.c_str(), ios::in | ios::binary) {}
+bool NodeSetFileReader::isOpen() const {
+	return in.is_open();
+}
+bool NodeSetFileReader::readNumber(unsigned int& x) {
+	x = 0;
+	for (int shift=0; ; shift += 7) {
+		int c = in.get();
+		if (c == EOF) {
+			return false;
+		}
+		x |= (unsigned int)(c & 0x7F) << shift;
+		if (!(c & 0x80)) {
+			return true;
+		}
+	}
+}
+bool NodeSetFileReader::read(NodeSet& nodeSet) {
+	unsigned int size, x;
+	if (!readNumber(size)) {
+		return false;
+	}
+	nodeSet.resize(size);
+	for (unsigned int i=0; i<size; ++i) {
+		if (!readNumber(x)) {
+			return false;
+		}
+		nodeSet[i] = (i == 0 ? x : nodeSet[i-1] + x + 1);
+	}
+	return true;
+}
+
+/*
+ * The supported node set types
+ */
+#define DATASTRUCTURES_INSTANTIATE(_type) \
+	template class BasicWeightedNodeSetQueue< _type >; \
+	template class BasicNodeSetSet< _type >;
+DATASTRUCTURES_INSTANTIATE(NodeSet)
+DATASTRUCTURES_INSTANTIATE(NodeBitSet<1>)
+DATASTRUCTURES_INSTANTIATE(NodeBitSet<2>)
+DATASTRUCTURES_INSTANTIATE(NodeBitSet<4>)
+DATASTRUCTURES_INSTANTIATE(DynamicNodeBitSet)
+
 } /* namespace tdenum */
@@ -13,6 +13,8 @@
 #include <algorithm>
 #include <string>
 #include <memory>
+#include <ostream>
+#include <fstream>
 
 using namespace std;
 
@@ -25,6 +27,162 @@ typedef int Node;
 typedef vector<Node> NodeSet; // sorted vector of node names
 typedef NodeSet MinimalSeparator;
 
+/**
+ * Bit words, used by the dense (bitset) structures.
+ */
+typedef unsigned long long BitWord;
+#define BITWORD_BITS (64)
+// Number of words required to hold _n bits
+#define BITWORDS_FOR(_n) (((_n) + BITWORD_BITS - 1) / BITWORD_BITS)
+#define BITWORD_INDEX(_v) ((_v) / BITWORD_BITS)
+#define BITWORD_MASK(_v) (BitWord(1) << ((_v) % BITWORD_BITS))
+
+inline int bitword_count(BitWord w) { return __builtin_popcountll(w); }
+inline int bitword_lowest(BitWord w) { return __builtin_ctzll(w); }
+
+// Appends the nodes whose bits are set in the given words to the output, in
+// ascending order.
+void bitwords_to_nodeset(const BitWord* words, int numWords, NodeSet& out);
+
+/*
+ * A node set kept as a bitset: v is in the set <==> bit v is set.
+ * NodeBitSet<W> holds up to 64*W nodes in place and never allocates.
+ * NodeBitSet<0> (DynamicNodeBitSet) has no capacity limit, and keeps no
+ * trailing zero words so equal sets always have equal words.
+ * Ordering (operator<) and toNodeSet() agree with the sorted NodeSet holding
+ * the same nodes, so ordered containers of either behave the same.
+ */
+// Returns true <==> the nodes of a, listed in ascending order, precede the
+// nodes of b lexicographically (as NodeSets compare).
+bool bitwords_less(const BitWord* a, int na, const BitWord* b, int nb);
+size_t bitwords_hash(const BitWord* words, int numWords);
+// Reports a node that doesn't fit in a fixed width bitset
+void bitset_capacity_error(Node v, int capacity);
+
+template<int W>
+class NodeBitSet {
+	BitWord words[W];
+public:
+	static const int CAPACITY = W*BITWORD_BITS;
+	NodeBitSet() { clear(); }
+	explicit NodeBitSet(const NodeSet& nodes) {
+		clear();
+		for (Node v : nodes) insert(v);
+	}
+	// Copies the first numWords of the given row
+	NodeBitSet(const BitWord* row, int numWords) {
+		clear();
+		std::copy(row, row + std::min(numWords, W), words);
+	}
+	void clear() { std::fill(words, words+W, BitWord(0)); }
+	// Nodes beyond the capacity are reported and ignored (use
+	// DynamicNodeBitSet when the graph size isn't known in advance)
+	void insert(Node v) {
+		if (v >= CAPACITY) {
+			bitset_capacity_error(v, CAPACITY);
+			return;
+		}
+		words[BITWORD_INDEX(v)] |= BITWORD_MASK(v);
+	}
+	void remove(Node v) {
+		if (v < CAPACITY) {
+			words[BITWORD_INDEX(v)] &= ~BITWORD_MASK(v);
+		}
+	}
+	bool contains(Node v) const {
+		return v < CAPACITY && (words[BITWORD_INDEX(v)] & BITWORD_MASK(v)) != 0;
+	}
+	int size() const {
+		int count = 0;
+		for (int i=0; i<W; ++i) count += bitword_count(words[i]);
+		return count;
+	}
+	bool empty() const {
+		for (int i=0; i<W; ++i) if (words[i]) return false;
+		return true;
+	}
+	bool isSubsetOf(const NodeBitSet& other) const {
+		for (int i=0; i<W; ++i) if (words[i] & ~other.words[i]) return false;
+		return true;
+	}
+	bool intersects(const NodeBitSet& other) const {
+		for (int i=0; i<W; ++i) if (words[i] & other.words[i]) return true;
+		return false;
+	}
+	NodeBitSet& operator|=(const NodeBitSet& other) {
+		for (int i=0; i<W; ++i) words[i] |= other.words[i];
+		return *this;
+	}
+	NodeBitSet& operator&=(const NodeBitSet& other) {
+		for (int i=0; i<W; ++i) words[i] &= other.words[i];
+		return *this;
+	}
+	NodeBitSet& operator-=(const NodeBitSet& other) {
+		for (int i=0; i<W; ++i) words[i] &= ~other.words[i];
+		return *this;
+	}
+	NodeBitSet operator|(const NodeBitSet& other) const { return NodeBitSet(*this) |= other; }
+	NodeBitSet operator&(const NodeBitSet& other) const { return NodeBitSet(*this) &= other; }
+	NodeBitSet operator-(const NodeBitSet& other) const { return NodeBitSet(*this) -= other; }
+	bool operator==(const NodeBitSet& other) const { return std::equal(words, words+W, other.words); }
+	bool operator!=(const NodeBitSet& other) const { return !(*this == other); }
+	bool operator<(const NodeBitSet& other) const { return bitwords_less(words, W, other.words, W); }
+	size_t hash() const { return bitwords_hash(words, W); }
+	// The nodes in ascending order
+	NodeSet toNodeSet() const {
+		NodeSet result;
+		bitwords_to_nodeset(words, W, result);
+		return result;
+	}
+	const BitWord* data() const { return words; }
+	int getNumberOfWords() const { return W; }
+};
+
+template<>
+class NodeBitSet<0> {
+	vector<BitWord> words;
+	void trim() { while (!words.empty() && words.back() == 0) words.pop_back(); }
+public:
+	NodeBitSet() {}
+	explicit NodeBitSet(const NodeSet& nodes);
+	NodeBitSet(const BitWord* row, int numWords);
+	void clear() { words.clear(); }
+	void insert(Node v);
+	void remove(Node v);
+	bool contains(Node v) const {
+		return BITWORD_INDEX(v) < int(words.size()) &&
+			(words[BITWORD_INDEX(v)] & BITWORD_MASK(v)) != 0;
+	}
+	int size() const;
+	bool empty() const { return words.empty(); }
+	bool isSubsetOf(const NodeBitSet& other) const;
+	bool intersects(const NodeBitSet& other) const;
+	NodeBitSet& operator|=(const NodeBitSet& other);
+	NodeBitSet& operator&=(const NodeBitSet& other);
+	NodeBitSet& operator-=(const NodeBitSet& other);
+	NodeBitSet operator|(const NodeBitSet& other) const { return NodeBitSet(*this) |= other; }
+	NodeBitSet operator&(const NodeBitSet& other) const { return NodeBitSet(*this) &= other; }
+	NodeBitSet operator-(const NodeBitSet& other) const { return NodeBitSet(*this) -= other; }
+	bool operator==(const NodeBitSet& other) const { return words == other.words; }
+	bool operator!=(const NodeBitSet& other) const { return !(*this == other); }
+	bool operator<(const NodeBitSet& other) const {
+		return bitwords_less(words.data(), words.size(), other.words.data(), other.words.size());
+	}
+	size_t hash() const { return bitwords_hash(words.data(), words.size()); }
+	NodeSet toNodeSet() const;
+	const BitWord* data() const { return words.data(); }
+	int getNumberOfWords() const { return words.size(); }
+};
+typedef NodeBitSet<0> DynamicNodeBitSet;
+
+// Uniform access to the different node set types.
+size_t nodeset_hash(const NodeSet& nodes);
+template<int W>
+size_t nodeset_hash(const NodeBitSet<W>& nodes) { return nodes.hash(); }
+inline const NodeSet& to_nodeset(const NodeSet& nodes) { return nodes; }
+template<int W>
+NodeSet to_nodeset(const NodeBitSet<W>& nodes) { return nodes.toNodeSet(); }
+
 /**
  * Noam's structure
  */
@@ -32,33 +190,87 @@ struct Block {
 	const MinimalSeparator S;
 	const NodeSet C;
 	const NodeSet nodes;
-	const vector<bool> fullNodes;
-	Block(const MinimalSeparator& sep, const NodeSet& comp, int numNodes) :
-		S(sep), C(comp), nodes(getNodeSetUnion(sep,comp)), fullNodes(getFullNodeVector(nodes, numNodes)) {}
+	const DynamicNodeBitSet fullNodes;
+	Block(const MinimalSeparator& sep, const NodeSet& comp) :
+		S(sep), C(comp), nodes(getNodeSetUnion(sep,comp)), fullNodes(nodes) {}
 	static const NodeSet getNodeSetUnion(const NodeSet&, const NodeSet&);
-	static const vector<bool> getFullNodeVector(const NodeSet&, int);
 	bool includesNodes(const NodeSet&) const;
 };
 
 typedef shared_ptr<Block> BlockPtr;
 typedef vector<BlockPtr> BlockVec;
 
+// A contiguous range of block locations (see BlockTable)
+class BlockIDRange {
+	const int* first;
+	const int* last;
+public:
+	BlockIDRange(const int* f, const int* l) : first(f), last(l) {}
+	const int* begin() const { return first; }
+	const int* end() const { return last; }
+	int size() const { return last - first; }
+};
+
 /**
  * Utility functions
  */
 string str_nodeset(const NodeSet&);
 void print(const NodeSet&);
 
+/*
+ * A dense adjacency matrix: one bit row per node, where bit u in row v is set
+ * <==> (u,v) is an edge.
+ * Rows are padded to a whole number of words. Graphs with at most 64, 128 or
+ * 256 nodes use rows of 1, 2 or 4 words respectively, and the row operations
+ * are unrolled for these widths. Larger graphs use a dynamic width.
+ */
+class AdjacencyMatrix {
+	int numberOfNodes;
+	int wordsPerRow;
+	vector<BitWord> rows;
+public:
+	AdjacencyMatrix(int numberOfNodes = 0);
+	// Removes all edges, and resizes the matrix to the given number of nodes
+	void reset(int numberOfNodes);
+	// The row width (in words) used for the current number of nodes
+	static int rowWidth(int numberOfNodes);
+	int getWordsPerRow() const { return wordsPerRow; }
+	void addEdge(Node u, Node v) {
+		rows[u*wordsPerRow + BITWORD_INDEX(v)] |= BITWORD_MASK(v);
+		rows[v*wordsPerRow + BITWORD_INDEX(u)] |= BITWORD_MASK(u);
+	}
+	bool hasEdge(Node u, Node v) const {
+		return (rows[u*wordsPerRow + BITWORD_INDEX(v)] & BITWORD_MASK(v)) != 0;
+	}
+	// The neighbors of v, as getWordsPerRow() words
+	const BitWord* row(Node v) const { return &rows[v*wordsPerRow]; }
+	// out |= N(v). out must hold getWordsPerRow() words.
+	void orRow(Node v, BitWord* out) const;
+	// out |= N(v) for every v in [first,last).
+	void orRows(const Node* first, const Node* last, BitWord* out) const;
+	// Returns true <==> some node of the row of v is set in the given words
+	bool rowIntersects(Node v, const BitWord* words) const;
+};
+
 /*
  * A maximum heap. Can be used for Maximum Cardinality Search.
+ * Weights start at 0 and only increase by 1, so the nodes are kept in buckets
+ * by weight. Each bucket is a max heap of nodes (ties are broken by the
+ * larger node); a node whose weight increased is left in its old bucket and
+ * skipped once it reaches the top.
  */
 class IncreasingWeightNodeQueue {
 	vector<int> weight;
-	set< pair<int,Node> > queue;
+	vector< vector<Node> > buckets;
+	// Number of nodes in the queue with each weight
+	vector<int> bucketSizes;
+	int maxWeight;
+	int numberOfNodesLeft;
 public:
 	IncreasingWeightNodeQueue(int numberOfNodes);
 	// Increase the weight of the node by 1.
-	// Node is assumed to be an integer between 0 and numberOfNodes-1.
+	// Node is assumed to be an integer between 0 and numberOfNodes-1, which
+	// was not popped yet.
 	void increaseWeight(Node v);
 	// Returns the weight of the node. This is also available after pop.
 	// Node is assumed to be an integer between 0 and numberOfNodes-1.
@@ -69,46 +281,115 @@ public:
 	Node pop();
 };
 
+/*
+ * A minimum heap of nodes by integer keys, ties broken by the smaller node.
+ * Each node is in the heap at most once, and its key can be changed in place.
+ */
+class IndexedNodeHeap {
+	vector<Node> heap;
+	vector<int> keys;
+	// The index of every node in heap, or -1 if it isn't there
+	vector<int> positions;
+	bool isBefore(int i, int j) const;
+	void swapEntries(int i, int j);
+	void siftUp(int i);
+	void siftDown(int i);
+public:
+	IndexedNodeHeap(int numberOfNodes);
+	// Inserts a node that is not in the heap.
+	// Node is assumed to be an integer between 0 and numberOfNodes-1.
+	void push(Node v, int key);
+	// Changes the key of a node in the heap (up or down).
+	void update(Node v, int key);
+	bool contains(Node v) const { return positions[v] >= 0; }
+	// Returns the key of the node. This is also available after pop.
+	int getKey(Node v) const { return keys[v]; }
+	bool isEmpty() const { return heap.empty(); }
+	// Returns the node with the minimal key
+	Node top() const { return heap.front(); }
+	// Returns and removes the node with the minimal key.
+	Node pop();
+};
+
 /*
  * A minimum heap.
+ * SetType may be NodeSet or any NodeBitSet (see the instantiations at the
+ * bottom of DataStructures.cpp).
  */
-class WeightedNodeSetQueue {
-	set< pair<int, NodeSet > > queue;
+template<class SetType>
+class BasicWeightedNodeSetQueue {
+	set< pair<int, SetType > > queue;
 public:
 	// True if the structure is empty.
 	bool isEmpty();
 	// True if the structure contains the given node set with the given weight.
-	bool isMember(const NodeSet& nodeSet, int weight);
+	bool isMember(const SetType& nodeSet, int weight);
 	// Adds the given node set to the structure with the given weight.
-	void insert(const NodeSet& nodeSet, int weight);
+	void insert(const SetType& nodeSet, int weight);
 	// Returns the maximal weighted node set, and removes it from the structure.
-	NodeSet pop();
+	SetType pop();
 };
+typedef BasicWeightedNodeSetQueue<NodeSet> WeightedNodeSetQueue;
 
-class NodeSetSet {
-	set< NodeSet > sets;
+/*
+ * A set of node sets.
+ * SetType may be NodeSet or any NodeBitSet (see the instantiations at the
+ * bottom of DataStructures.cpp).
+ * The node sets are kept contiguously, along with a 64 bit fingerprint of
+ * each, and are iterated in the order they are stored. Lookups go through an
+ * open addressing table of indices, probed linearly, so only sets with equal
+ * fingerprints are ever compared.
+ * Sets are stored in insertion order, until remove() moves the last set into
+ * the place of the removed one. So while nothing was removed, the iteration
+ * order is the insertion order, and a set's index (its iterator minus
+ * begin()) stays the same.
+ * Use sorted() when a canonical order is required.
+ */
+template<class SetType>
+class BasicNodeSetSet {
+	vector<SetType> sets;
+	vector<unsigned long long> fingerprints;
+	// Indices into sets, or EMPTY_SLOT. The size is 0 or a power of 2, and
+	// the table is kept at most half full.
+	vector<int> table;
+	enum { EMPTY_SLOT = -1 };
+	unsigned int slotMask() const { return table.size() - 1; }
+	// The slot holding the given node set, or the empty slot where it belongs
+	unsigned int findSlot(const SetType& nodeSet, unsigned long long fingerprint) const;
+	// The slot pointing at the given index
+	unsigned int findIndexSlot(int index) const;
+	void eraseSlot(unsigned int slot);
+	void rehash(unsigned int tableSize);
 public:
-    NodeSetSet(const set<NodeSet>& = set<NodeSet>());
-    // True if the structure contains the given node set.
-	bool isMember(const NodeSet& nodeSet) const;
-	bool operator==(const NodeSetSet& nss) const;
-	bool operator!=(const NodeSetSet& nss) const;
+	typedef typename vector<SetType>::const_iterator iterator;
+	BasicNodeSetSet(const set<SetType>& = set<SetType>());
+	// True if the structure contains the given node set.
+	bool isMember(const SetType& nodeSet) const;
+	bool operator==(const BasicNodeSetSet& nss) const;
+	bool operator!=(const BasicNodeSetSet& nss) const;
 	// Adds / removes the given node set to / from the structure.
-	void insert(const NodeSet& nodeSet);
-	void remove(const NodeSet& nodeSet);
-	NodeSetSet unify(const NodeSetSet& other) const;
-	// Prints out the NodeSets
+	void insert(const SetType& nodeSet);
+	void remove(const SetType& nodeSet);
+	BasicNodeSetSet unify(const BasicNodeSetSet& other) const;
+	// Prints out the NodeSets, in ascending order
 	string str() const;
+	// Returns the node sets in ascending order
+	vector<SetType> sorted() const;
 	// std::set methods
 	unsigned int size() const;
 	bool empty() const;
 	void clear();
-	set<NodeSet>::iterator begin() const;
-	set<NodeSet>::iterator end() const;
-	set<NodeSet>::iterator find(const NodeSet& nodeSet) const;
-	operator set<NodeSet>() const { return sets; }
-	friend ostream& operator<<(ostream& os, const NodeSetSet&);
+	void swap(BasicNodeSetSet& other);
+	iterator begin() const;
+	iterator end() const;
+	iterator find(const SetType& nodeSet) const;
+	operator set<SetType>() const { return set<SetType>(sets.begin(), sets.end()); }
 };
+template<class SetType>
+ostream& operator<<(ostream& os, const BasicNodeSetSet<SetType>& nss) {
+	return os << nss.str();
+}
+typedef BasicNodeSetSet<NodeSet> NodeSetSet;
 
 
 /*
@@ -129,6 +410,35 @@ public:
 	NodeSet produce();
 };
 
+/*
+ * Binary files of node sets, read back in the order they were written.
+ * Each node set (sorted ascending) is stored as its size, its first node and
+ * the gaps between consecutive nodes, all as base-128 varints. Sets of close
+ * nodes take a byte or two per node.
+ */
+class NodeSetFileWriter {
+	ofstream out;
+	long count;
+	void writeNumber(unsigned int x);
+public:
+	NodeSetFileWriter(const string& filename);
+	// False if the file couldn't be opened
+	bool isOpen() const;
+	void write(const NodeSet& nodeSet);
+	// Number of node sets written so far
+	long getCount() const;
+	void close();
+};
+class NodeSetFileReader {
+	ifstream in;
+	bool readNumber(unsigned int& x);
+public:
+	NodeSetFileReader(const string& filename);
+	bool isOpen() const;
+	// Reads the next node set. Returns false at the end of the file.
+	bool read(NodeSet& nodeSet);
+};
+
 } /* namespace tdenum */
 
 #endif /* DATASTRUCTURES_H_ */
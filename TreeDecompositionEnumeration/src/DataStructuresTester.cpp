@@ -0,0 +1,346 @@
+#include "DataStructuresTester.h"
+#include "DataStructures.h"
+#include <cstdlib>
+
+namespace tdenum {
+
+// A random sorted node set, with nodes smaller than n
+static NodeSet random_nodeset(int n, int oneIn) {
+    NodeSet s;
+    for (Node v=0; v<n; ++v) {
+        if (rand() % oneIn == 0) {
+            s.push_back(v);
+        }
+    }
+    return s;
+}
+
+template<class BitSet>
+static bool bit_set_basic_aux(int n) {
+    for (int i=0; i<50; ++i) {
+        NodeSet s = random_nodeset(n, 1 + i%7);
+        BitSet b(s);
+        ASSERT_EQ(b.toNodeSet(), s);
+        ASSERT_EQ(b.size(), int(s.size()));
+        ASSERT_EQ(b.empty(), s.empty());
+        for (Node v=0; v<n; ++v) {
+            ASSERT_EQ(b.contains(v), (UTILS__IS_IN_SORTED_CONTAINER(v, s)));
+        }
+        // Remove everything, one node at a time
+        for (Node v : s) {
+            b.remove(v);
+            ASSERT(!b.contains(v));
+        }
+        ASSERT(b.empty());
+        ASSERT(b == BitSet());
+        ASSERT_EQ(b.hash(), BitSet().hash());
+    }
+    return true;
+}
+
+bool DataStructuresTester::node_bit_set_basic() const {
+    ASSERT(bit_set_basic_aux< NodeBitSet<1> >(64));
+    ASSERT(bit_set_basic_aux< NodeBitSet<2> >(128));
+    ASSERT(bit_set_basic_aux< NodeBitSet<4> >(256));
+    ASSERT(bit_set_basic_aux< DynamicNodeBitSet >(300));
+    // Copying rows
+    NodeSet s({0,5,63,64,200});
+    NodeBitSet<4> fixed(s);
+    ASSERT_EQ(DynamicNodeBitSet(fixed.data(), 4).toNodeSet(), s);
+    ASSERT_EQ(NodeBitSet<4>(DynamicNodeBitSet(s).data(), 4).toNodeSet(), s);
+    // Equal sets have the same hash regardless of their width
+    ASSERT_EQ(fixed.hash(), DynamicNodeBitSet(s).hash());
+    // Nodes beyond the capacity are ignored, and don't touch the memory
+    // after the set
+    NodeBitSet<1> adjacent[2];
+    adjacent[0].insert(3);
+    adjacent[0].insert(64);
+    adjacent[0].insert(130);
+    adjacent[0].remove(64);
+    ASSERT_EQ(adjacent[0].toNodeSet(), NodeSet({3}));
+    ASSERT(!adjacent[0].contains(64));
+    ASSERT(adjacent[1].empty());
+    ASSERT_EQ(NodeBitSet<1>(NodeSet({1,70})).toNodeSet(), NodeSet({1}));
+    return true;
+}
+
+template<class BitSet>
+static bool bit_set_ops_aux(int n) {
+    for (int i=0; i<100; ++i) {
+        NodeSet a = random_nodeset(n, 1 + i%5);
+        NodeSet b = random_nodeset(n, 1 + i%3);
+        BitSet A(a), B(b);
+        NodeSet expected;
+        std::set_union(a.begin(), a.end(), b.begin(), b.end(), back_inserter(expected));
+        ASSERT_EQ((A|B).toNodeSet(), expected);
+        expected.clear();
+        std::set_intersection(a.begin(), a.end(), b.begin(), b.end(), back_inserter(expected));
+        ASSERT_EQ((A&B).toNodeSet(), expected);
+        ASSERT_EQ(A.intersects(B), !expected.empty());
+        expected.clear();
+        std::set_difference(a.begin(), a.end(), b.begin(), b.end(), back_inserter(expected));
+        ASSERT_EQ((A-B).toNodeSet(), expected);
+        ASSERT_EQ(A.isSubsetOf(B), expected.empty());
+        ASSERT((A&B).isSubsetOf(A));
+        ASSERT(A.isSubsetOf(A|B));
+        ASSERT_EQ((A == B), (a == b));
+        if (a == b) {
+            ASSERT_EQ(A.hash(), B.hash());
+        }
+        ASSERT_EQ(BitSet(a).hash(), A.hash());
+    }
+    return true;
+}
+
+bool DataStructuresTester::node_bit_set_ops() const {
+    ASSERT(bit_set_ops_aux< NodeBitSet<1> >(64));
+    ASSERT(bit_set_ops_aux< NodeBitSet<2> >(128));
+    ASSERT(bit_set_ops_aux< NodeBitSet<4> >(256));
+    ASSERT(bit_set_ops_aux< DynamicNodeBitSet >(300));
+    // Dynamic sets of different lengths
+    ASSERT(bit_set_ops_aux< DynamicNodeBitSet >(10));
+    DynamicNodeBitSet shortSet(NodeSet({1,2})), longSet(NodeSet({1,2,400}));
+    ASSERT(shortSet.isSubsetOf(longSet));
+    ASSERT(!longSet.isSubsetOf(shortSet));
+    ASSERT((longSet & shortSet) == shortSet);
+    ASSERT((longSet - DynamicNodeBitSet(NodeSet({400}))) == shortSet);
+    return true;
+}
+
+template<class BitSet>
+static bool bit_set_order_aux(int n) {
+    for (int i=0; i<300; ++i) {
+        NodeSet a = random_nodeset(n, 2 + i%9);
+        NodeSet b = random_nodeset(n, 2 + i%4);
+        // Also compare prefixes
+        if (i % 3 == 0 && !b.empty()) {
+            a = NodeSet(b.begin(), b.begin() + rand() % b.size());
+        }
+        ASSERT_EQ((BitSet(a) < BitSet(b)), (a < b));
+        ASSERT_EQ((BitSet(b) < BitSet(a)), (b < a));
+    }
+    return true;
+}
+
+bool DataStructuresTester::node_bit_set_order() const {
+    ASSERT(bit_set_order_aux< NodeBitSet<1> >(64));
+    ASSERT(bit_set_order_aux< NodeBitSet<2> >(128));
+    ASSERT(bit_set_order_aux< NodeBitSet<4> >(256));
+    ASSERT(bit_set_order_aux< DynamicNodeBitSet >(300));
+    ASSERT(!(DynamicNodeBitSet() < DynamicNodeBitSet()));
+    ASSERT(DynamicNodeBitSet() < DynamicNodeBitSet(NodeSet({0})));
+    ASSERT(DynamicNodeBitSet(NodeSet({1,200})) < DynamicNodeBitSet(NodeSet({1,300})));
+    ASSERT(DynamicNodeBitSet(NodeSet({1,200})) < DynamicNodeBitSet(NodeSet({2})));
+    return true;
+}
+
+template<class BitSet>
+static bool node_set_containers_aux(int n) {
+    NodeSetSet nss;
+    BasicNodeSetSet<BitSet> bss;
+    WeightedNodeSetQueue nq;
+    BasicWeightedNodeSetQueue<BitSet> bq;
+    for (int i=0; i<100; ++i) {
+        NodeSet s = random_nodeset(n, 3);
+        nss.insert(s);
+        bss.insert(BitSet(s));
+        ASSERT(bss.isMember(BitSet(s)));
+        nq.insert(s, i%5);
+        bq.insert(BitSet(s), i%5);
+    }
+    ASSERT_EQ(nss.size(), bss.size());
+    ASSERT_EQ(nss.str(), bss.str());
+    while (!nq.isEmpty()) {
+        ASSERT(!bq.isEmpty());
+        ASSERT_EQ(nq.pop(), bq.pop().toNodeSet());
+    }
+    ASSERT(bq.isEmpty());
+    return true;
+}
+
+bool DataStructuresTester::node_set_containers() const {
+    ASSERT(node_set_containers_aux< NodeBitSet<1> >(64));
+    ASSERT(node_set_containers_aux< NodeBitSet<2> >(100));
+    ASSERT(node_set_containers_aux< NodeBitSet<4> >(256));
+    ASSERT(node_set_containers_aux< DynamicNodeBitSet >(300));
+    return true;
+}
+
+bool DataStructuresTester::node_set_set_hashing() const {
+    // Random inserts and removes, compared against a std::set
+    NodeSetSet nss;
+    set<NodeSet> reference;
+    for (int i=0; i<5000; ++i) {
+        NodeSet s = random_nodeset(12, 3);
+        if (rand() % 3 == 0) {
+            nss.remove(s);
+            reference.erase(s);
+        }
+        else {
+            nss.insert(s);
+            reference.insert(s);
+        }
+        ASSERT_EQ(nss.size(), reference.size());
+        ASSERT(nss.isMember(s) == (reference.find(s) != reference.end()));
+    }
+    // Iteration covers every node set exactly once
+    set<NodeSet> iterated(nss.begin(), nss.end());
+    ASSERT_EQ(iterated.size(), nss.size());
+    ASSERT(iterated == reference);
+    ASSERT(set<NodeSet>(nss) == reference);
+    vector<NodeSet> sorted = nss.sorted();
+    ASSERT(sorted == vector<NodeSet>(reference.begin(), reference.end()));
+    ASSERT_EQ(nss.str(), NodeSetSet(reference).str());
+    for (auto it = nss.begin(); it != nss.end(); ++it) {
+        ASSERT(nss.find(*it) == it);
+    }
+    // Equality doesn't depend on insertion order
+    NodeSetSet reversed;
+    for (auto it = reference.rbegin(); it != reference.rend(); ++it) {
+        reversed.insert(*it);
+    }
+    ASSERT(reversed == nss);
+    reversed.remove(*reference.begin());
+    ASSERT(reversed != nss);
+    ASSERT(reversed.unify(nss) == nss);
+    // Remove everything
+    for (auto s : reference) {
+        nss.remove(s);
+        ASSERT(!nss.isMember(s));
+    }
+    ASSERT(nss.empty());
+    ASSERT(nss.find(NodeSet()) == nss.end());
+    nss.insert(NodeSet());
+    ASSERT(nss.isMember(NodeSet()));
+    nss.clear();
+    ASSERT(!nss.isMember(NodeSet()));
+    return true;
+}
+
+bool DataStructuresTester::node_set_file() const {
+    string filename = tmp_dir_name+"/node_sets.bin";
+    vector<NodeSet> written;
+    written.push_back(NodeSet());
+    written.push_back(NodeSet({0}));
+    written.push_back(NodeSet({127, 128, 300, 20000, 1000000}));
+    for (int i=0; i<100; ++i) {
+        written.push_back(random_nodeset(1 + rand() % 500, 1 + rand() % 10));
+    }
+    NodeSetFileWriter writer(filename);
+    ASSERT(writer.isOpen());
+    for (auto s : written) {
+        writer.write(s);
+    }
+    ASSERT_EQ(writer.getCount(), long(written.size()));
+    writer.close();
+
+    NodeSetFileReader reader(filename);
+    ASSERT(reader.isOpen());
+    NodeSet s;
+    for (unsigned i=0; i<written.size(); ++i) {
+        ASSERT(reader.read(s));
+        ASSERT_EQ(s, written[i]);
+    }
+    ASSERT(!reader.read(s));
+    ASSERT(!NodeSetFileReader(tmp_dir_name+"/no_such_file").isOpen());
+    return true;
+}
+
+bool DataStructuresTester::increasing_weight_queue() const {
+    // Compare against a set of (weight, node) pairs, popped from the end
+    for (int i=0; i<20; ++i) {
+        int n = 1 + rand() % 100;
+        IncreasingWeightNodeQueue queue(n);
+        set< pair<int,Node> > expected;
+        vector<int> weight(n, 0);
+        for (Node v=0; v<n; ++v) {
+            expected.insert(make_pair(0, v));
+        }
+        while (!expected.empty()) {
+            ASSERT(!queue.isEmpty());
+            pair<int,Node> top = *expected.rbegin();
+            expected.erase(top);
+            ASSERT_EQ(queue.pop(), top.second);
+            ASSERT_EQ(queue.getWeight(top.second), top.first);
+            // Increase some of the remaining nodes, some of them twice
+            vector< pair<int,Node> > remaining(expected.begin(), expected.end());
+            for (unsigned j=0; j<remaining.size(); ++j) {
+                Node v = remaining[j].second;
+                int times = rand() % 4 == 0 ? 1 + rand() % 2 : 0;
+                for (int k=0; k<times; ++k) {
+                    expected.erase(make_pair(weight[v], v));
+                    weight[v]++;
+                    expected.insert(make_pair(weight[v], v));
+                    queue.increaseWeight(v);
+                }
+            }
+        }
+        ASSERT(queue.isEmpty());
+    }
+    return true;
+}
+
+bool DataStructuresTester::indexed_node_heap() const {
+    // Compare against a set of (key, node) pairs, popped from the beginning
+    for (int i=0; i<20; ++i) {
+        int n = 1 + rand() % 100;
+        IndexedNodeHeap heap(n);
+        set< pair<int,Node> > expected;
+        for (Node v=0; v<n; ++v) {
+            int key = rand() % 10;
+            heap.push(v, key);
+            expected.insert(make_pair(key, v));
+        }
+        while (!expected.empty()) {
+            // Change some keys, in both directions
+            vector< pair<int,Node> > remaining(expected.begin(), expected.end());
+            for (unsigned j=0; j<remaining.size(); ++j) {
+                if (rand() % 3 == 0) {
+                    Node v = remaining[j].second;
+                    int key = remaining[j].first + rand() % 7 - 3;
+                    expected.erase(remaining[j]);
+                    expected.insert(make_pair(key, v));
+                    heap.update(v, key);
+                    ASSERT_EQ(heap.getKey(v), key);
+                }
+            }
+            ASSERT(!heap.isEmpty());
+            pair<int,Node> top = *expected.begin();
+            expected.erase(top);
+            ASSERT_EQ(heap.top(), top.second);
+            ASSERT_EQ(heap.pop(), top.second);
+            ASSERT(!heap.contains(top.second));
+            ASSERT_EQ(heap.getKey(top.second), top.first);
+        }
+        ASSERT(heap.isEmpty());
+    }
+    return true;
+}
+
+DataStructuresTester::DataStructuresTester() :
+    TestInterface("DataStructures Tester")
+    #define X(_func) , flag_##_func(true)
+    DATASTRUCTURES_TEST_TABLE
+    #undef X
+    {}
+
+DataStructuresTester& DataStructuresTester::go() {
+    #define X(_func) if (flag_##_func) DO_TEST(_func);
+    DATASTRUCTURES_TEST_TABLE
+    #undef X
+    return *this;
+}
+DataStructuresTester& DataStructuresTester::set_all() {
+    #define X(_func) flag_##_func = true;
+    DATASTRUCTURES_TEST_TABLE
+    #undef X
+    return *this;
+}
+DataStructuresTester& DataStructuresTester::clear_all() {
+    #define X(_func) flag_##_func = false;
+    DATASTRUCTURES_TEST_TABLE
+    #undef X
+    return *this;
+}
+
+}
@@ -0,0 +1,51 @@
+#ifndef DATASTRUCTURESTESTER_H_INCLUDED
+#define DATASTRUCTURESTESTER_H_INCLUDED
+
+#include "DataStructures.h"
+#include "TestInterface.h"
+
+namespace tdenum {
+
+#define DATASTRUCTURES_TEST_TABLE \
+    X(node_bit_set_basic) \
+    X(node_bit_set_ops) \
+    X(node_bit_set_order) \
+    X(node_set_containers) \
+    X(node_set_set_hashing) \
+    X(node_set_file) \
+    X(increasing_weight_queue) \
+    X(indexed_node_heap)
+
+#define X(func) DATASTRUCTURES_TEST_NAME__##func,
+typedef enum {
+    DATASTRUCTURES_TEST_TABLE
+    DATASTRUCTURES_TEST_NAME__LAST
+} DataStructuresTesterFunctions;
+#undef X
+
+class DataStructuresTester : public TestInterface {
+private:
+    // Calls all tests with flag_ values set to true.
+    DataStructuresTester& go();
+
+public:
+
+    // Declare all functions and their on/off flags.
+    #define X(_func) \
+        bool _func() const; \
+        bool flag_##_func;
+    DATASTRUCTURES_TEST_TABLE
+    #undef X
+
+    DataStructuresTester();
+
+    // Sets / clears all flags
+    DataStructuresTester& set_all();
+    DataStructuresTester& clear_all();
+
+};
+
+}
+
+
+#endif // DATASTRUCTURESTESTER_H_INCLUDED
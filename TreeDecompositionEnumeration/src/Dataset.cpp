@@ -150,7 +150,11 @@ Dataset& Dataset::calc_ms(GraphStats& gs, const StatisticRequest& sr) {
     // Init
     NodeSetSet min_seps;
     MinimalSeparatorsEnumerator mse(gs.get_graph(), UNIFORM);
-    time_t t = time(NULL);
+    mse.setCancellationToken(cancel_token);
+    Deadline deadline;
+    if (sr.test_time_limit_ms()) {
+        deadline.set_strict_limit(sr.get_time_limit_ms());
+    }
     min_seps.clear();
     long ms_count = 0;
     gs.set_ms_count(ms_count);
@@ -159,13 +163,12 @@ Dataset& Dataset::calc_ms(GraphStats& gs, const StatisticRequest& sr) {
     // Catch memory errors
     try {
         TRACE(TRACE_LVL__TEST, "In try\{} block with the following graph:\n" << gs.get_graph());
-        time_t start_time = time(NULL);
         while(mse.hasNext()) {
             // No need to store the separators if they weren't requested.
             // We do need to advance the MS enumerator, though.
             auto next = mse.next();
             ++ms_count;
-            time_t time_taken = difftime(time(NULL), start_time);
+            double time_taken = deadline.elapsed();
 
             // Set count AFTER setting (possible) separators, as the above updates the count automatically.
             if (sr.test_ms()) {
@@ -187,10 +190,10 @@ Dataset& Dataset::calc_ms(GraphStats& gs, const StatisticRequest& sr) {
                 gs.set_reached_count_limit_ms();
                 break;
             }
-            if (sr.test_time_limit_ms() && gs.get_ms_calc_time() > sr.get_time_limit_ms()) {
+            if (deadline.expired_now()) {
                 TRACE(TRACE_LVL__WARNING, "Reached time limit in MS calculation for graph '"
                             << gs.get_text() << "' (used "
-                            << gs.get_ms_calc_time() << " seconds, limited to "
+                            << deadline.elapsed() << " seconds, limited to "
                             << sr.get_time_limit_ms() << ")");
                 gs.set_reached_time_limit_ms();
                 break;
@@ -201,9 +204,13 @@ Dataset& Dataset::calc_ms(GraphStats& gs, const StatisticRequest& sr) {
         TRACE(TRACE_LVL__ERROR, "Caught std::bad_alloc while calculating separators! Setting MS 'valid' field to FALSE");
         gs.set_mem_error_ms();
     }
+    if (cancel_token.is_cancelled()) {
+        TRACE(TRACE_LVL__WARNING, "MS calculation for graph '" << gs.get_text() << "' was cancelled");
+        gs.set_reached_time_limit_ms();
+    }
     // That's it.
     end_progress_report();
-    gs.set_ms_calc_time(difftime(time(NULL),t));// If there are no separators, this is never updated
+    gs.set_ms_calc_time(deadline.elapsed());// If there are no separators, this is never updated
     TRACE(TRACE_LVL__TEST, "Timestamp difference: " << gs.get_ms_calc_time());
     TRACE(TRACE_LVL__TEST, "Timestamp in hhmmss format: " << utils__timestamp_to_hhmmss(gs.get_ms_calc_time()));
     TRACE(TRACE_LVL__TEST,"SET MS COUNT TO " << gs.get_ms_count());
@@ -214,6 +221,7 @@ Dataset& Dataset::calc_pmc(GraphStats& gs, const StatisticRequest& sr) {
     CALC_SANITY(pmc_calculation);
 
     PMCRacer pmcr("tmp", false);
+    pmcr.set_cancellation_token(cancel_token);
     pmcr.add(gs);
     TRACE(TRACE_LVL__TEST, "In");
     pmcr.go(sr, verbose);
@@ -285,8 +293,12 @@ Dataset& Dataset::calc_trng(GraphStats& gs, const StatisticRequest& sr) {
     CALC_SANITY(trng_calculation);
 
     // Init
-    time_t start_time = time(NULL);
+    Deadline deadline;
+    if (sr.test_time_limit_trng()) {
+        deadline.set_strict_limit(sr.get_time_limit_trng());
+    }
     MinimalTriangulationsEnumerator mte(gs.get_graph(), NONE, UNIFORM, MCS_M);
+    mte.setCancellationToken(cancel_token);
     long trng_count = 0;
     gs.set_trng_count(trng_count);
     gs.set_trng(vector<ChordalGraph>());
@@ -297,7 +309,7 @@ Dataset& Dataset::calc_trng(GraphStats& gs, const StatisticRequest& sr) {
             // Calculate
             ++trng_count;
             ChordalGraph triangulation = mte.next();
-            time_t time_taken = difftime(time(NULL), start_time);
+            double time_taken = deadline.elapsed();
             // Update fields
             gs.set_trng_calc_time(time_taken);
             if (sr.test_trng()) {
@@ -315,10 +327,10 @@ Dataset& Dataset::calc_trng(GraphStats& gs, const StatisticRequest& sr) {
                 gs.set_reached_count_limit_trng();
                 return *this;
             }
-            if (sr.test_time_limit_trng() && sr.get_time_limit_trng() < time_taken) {
+            if (deadline.expired_now()) {
                 TRACE(TRACE_LVL__WARNING, "Reached time limit in TRNG calculation for graph '"
                                 << gs.get_text() << "' (took "
-                                << time_taken << " seconds, limited to "
+                                << deadline.elapsed() << " seconds, limited to "
                                 << sr.get_time_limit_trng() << ")");
                 gs.set_reached_time_limit_trng();
                 return *this;
@@ -330,6 +342,11 @@ Dataset& Dataset::calc_trng(GraphStats& gs, const StatisticRequest& sr) {
         gs.set_mem_error_trng();
         return *this;
     }
+    if (cancel_token.is_cancelled()) {
+        TRACE(TRACE_LVL__WARNING, "TRNG calculation for graph '" << gs.get_text() << "' was cancelled");
+        gs.set_reached_time_limit_trng();
+        return *this;
+    }
     // If we're here, the calculated data is valid
     TRACE(TRACE_LVL__TEST, "Done, trng count is finally " << trng_count);
     UTILS__PRINT_IF(utils__has_substr(gs.get_text(), "Probability30percent/70.csv"),
@@ -339,7 +356,9 @@ Dataset& Dataset::calc_trng(GraphStats& gs, const StatisticRequest& sr) {
                     (gs.trng_no_errors() ? string("counted to ") + UTILS__TO_STRING(gs.get_trng_count()) : string("no count (error state)")));
 	return *this;
 }
-Dataset& Dataset::calc() {
+Dataset& Dataset::calc(const CancellationToken& token) {
+    cancel_token = token;
+
     // At this point we can ignore the contents of the target file (all relevant
     // data should already be loaded) so if we're in iterative dump mode, dump a
     // new file with a header a this point.
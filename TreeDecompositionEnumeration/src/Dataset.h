@@ -145,6 +145,7 @@ private:
     string file_path;       // Path to file containing statistics / dump target
     bool verbose;           // If true, progress reports will be displayed
     bool dump_each_graph;   // If true, each calculated graph will dump a row to the dump target
+    CancellationToken cancel_token; // Given to calc()
 
     // These print out CSV strings for output.
     // An entry will use the StatisticRequest object to determine which
@@ -288,7 +289,10 @@ public:
 
     // The main calculating method.
     // After finished calling the above methods, call this before dumping.
-    Dataset& calc();
+    // Once the token is cancelled, the calculations stop promptly. Whatever
+    // was calculated so far is kept, and the interrupted (and remaining)
+    // calculations are marked as out of time.
+    Dataset& calc(const CancellationToken& token = CancellationToken());
 
     // Dumps the statistics file.
     // The number and order of columns in all output statistic files should
@@ -1277,14 +1277,19 @@ bool DatasetTester::load_stat_files_same_statreq() {
         ASSERT_EQ(_gs1.reached_time_limit_flag_trng, _gs2.reached_time_limit_flag_trng);
         ASSERT_EQ(_gs1.mem_error_flag_ms, _gs2.mem_error_flag_ms);
         ASSERT_EQ(_gs1.mem_error_flag_trng, _gs2.mem_error_flag_trng);
-        ASSERT_EQ(_gs1.calc_time_ms, _gs2.calc_time_ms);
-        ASSERT_EQ(_gs1.calc_time_trng, _gs2.calc_time_trng);
+        // Times are stored in whole seconds
+        ASSERT_EQ(utils__timestamp_to_hhmmss(_gs1.calc_time_ms), utils__timestamp_to_hhmmss(_gs2.calc_time_ms));
+        ASSERT_EQ(utils__timestamp_to_hhmmss(_gs1.calc_time_trng), utils__timestamp_to_hhmmss(_gs2.calc_time_trng));
         ASSERT_EQ(_gs1.ms, _gs2.ms);
         ASSERT_EQ(_gs1.pmc, _gs2.pmc);
         ASSERT_EQ(_gs1.trng, _gs2.trng);
         ASSERT_EQ(_gs1.reached_time_limit_flag_pmc, _gs2.reached_time_limit_flag_pmc);
         ASSERT_EQ(_gs1.mem_error_flag_pmc, _gs2.mem_error_flag_pmc);
-        ASSERT_EQ(_gs1.calc_time_by_alg_pmc, _gs2.calc_time_by_alg_pmc);
+        ASSERT_EQ(_gs1.calc_time_by_alg_pmc.size(), _gs2.calc_time_by_alg_pmc.size());
+        for (auto alg_time: _gs1.calc_time_by_alg_pmc) {
+            ASSERT_EQ(utils__timestamp_to_hhmmss(alg_time.second),
+                      utils__timestamp_to_hhmmss(_gs2.calc_time_by_alg_pmc.at(alg_time.first)));
+        }
     }
     vector<StatisticRequest> sr_results = ds2.get_vector_sr();
     for (unsigned i=0; i<total_graphs; ++i) {
@@ -10,11 +10,14 @@
 
 namespace tdenum {
 
+int GRAPH_ADJACENCY_BACKEND = GRAPH_ADJACENCY_BITSET;
+
 Graph::Graph() : Graph(0) {}
 Graph::Graph(int numNodes) :
             numberOfNodes(numNodes),
             numberOfEdges(0),
             neighborSets(numberOfNodes),
+            adjacency(numberOfNodes),
             isRandomGraph(false),
             p(-1),
             instance(1),
@@ -30,6 +33,17 @@ Graph& Graph::reset(int n) {
     return *this;
 }
 
+void Graph::rebuildAdjacency() {
+    adjacency.reset(numberOfNodes);
+    for (Node u=0; u<numberOfNodes; ++u) {
+        for (Node v: neighborSets[u]) {
+            if (v < numberOfNodes) {
+                adjacency.addEdge(u,v);
+            }
+        }
+    }
+}
+
 bool Graph::nodeSanity() const {
     TRACE(TRACE_LVL__WARNING, "Called nodeSanity(), this will take " << numberOfNodes*(numberOfNodes-1)/2 << " steps!");
     for (Node u=0; u<numberOfNodes; ++u) {
@@ -56,6 +70,7 @@ Graph& Graph::randomize(double pr, int inst) {
     for (int i=0; i<numberOfNodes; ++i) {
         neighborSets[i].clear();
     }
+    adjacency.reset(numberOfNodes);
 
     NodeSet nodes = getNodesVector();
     double d;
@@ -109,6 +124,7 @@ Graph& Graph::removeAllButFirstK(int k) {
     }
     numberOfNodes = k;
     numberOfEdges = E/2;
+    rebuildAdjacency();
     return *this;
 }
 
@@ -145,6 +161,7 @@ vector<Node> Graph::nodeRenameAux(const vector<Node>& oldToNew) {
         }
     }
     neighborSets = newNeighbors;
+    rebuildAdjacency();
     composeNewToOld(oldToNew);
     return oldToNew;
 }
@@ -237,6 +254,7 @@ Graph& Graph::addEdge(Node u, Node v) {
 	}
 	neighborSets[u].insert(v);
 	neighborSets[v].insert(u);
+	adjacency.addEdge(u,v);
 	numberOfEdges++;
     return *this;
 }
@@ -330,6 +348,15 @@ const set<Node>& Graph::getNeighbors(Node v) const {
 
 vector<bool> Graph::getNeighborsMap(Node v) const {
 	vector<bool> result(numberOfNodes, false);
+	if (useBitset()) {
+		const BitWord* row = adjacency.row(v);
+		for (int i=0; i<adjacency.getWordsPerRow(); ++i) {
+			for (BitWord w = row[i]; w; w &= w-1) {
+				result[i*BITWORD_BITS + bitword_lowest(w)] = true;
+			}
+		}
+		return result;
+	}
 	for (set<Node>::iterator j = neighborSets[v].begin(); j != neighborSets[v].end(); ++j) {
 		result[*j] = true;
 	}
@@ -341,6 +368,9 @@ vector<bool> Graph::getNeighborsMap(Node v) const {
  * nodes that are in the input node set
  */
 NodeSet Graph::getNeighbors(const set<Node>& inputSet) const {
+	if (useBitset()) {
+		return getNeighborsBitset(inputSet.begin(), inputSet.end());
+	}
 	NodeSetProducer neighborsProducer(numberOfNodes);
 	for (set<Node>::const_iterator i = inputSet.begin(); i != inputSet.end(); ++i) {
 		Node v = *i;
@@ -358,6 +388,9 @@ NodeSet Graph::getNeighbors(const set<Node>& inputSet) const {
 }
 
 NodeSet Graph::getNeighbors(const vector<Node>& inputSet) const {
+	if (useBitset()) {
+		return getNeighborsBitset(inputSet.begin(), inputSet.end());
+	}
 	NodeSetProducer neighborsProducer(numberOfNodes);
 	for (vector<Node>::const_iterator i = inputSet.begin(); i != inputSet.end(); ++i) {
 		Node v = *i;
@@ -374,11 +407,35 @@ NodeSet Graph::getNeighbors(const vector<Node>& inputSet) const {
 	return neighborsProducer.produce();
 }
 
+// OR the rows of the input nodes together, then clear the input nodes
+template<class NodeIterator>
+NodeSet Graph::getNeighborsBitset(NodeIterator first, NodeIterator last) const {
+	vector<BitWord> neighbors(adjacency.getWordsPerRow(), 0);
+	for (NodeIterator i = first; i != last; ++i) {
+		if (!isValidNode(*i)) {
+			return NodeSet();
+		}
+		adjacency.orRow(*i, neighbors.data());
+	}
+	for (NodeIterator i = first; i != last; ++i) {
+		neighbors[BITWORD_INDEX(*i)] &= ~BITWORD_MASK(*i);
+	}
+	NodeSet result;
+	bitwords_to_nodeset(neighbors.data(), neighbors.size(), result);
+	return result;
+}
+
 bool Graph::areNeighbors(Node u, Node v) const {
+	if (useBitset()) {
+		return adjacency.hasEdge(u,v);
+	}
 	return neighborSets[u].find(v) != neighborSets[u].end();
 }
 
 vector<NodeSet> Graph::getComponents(const set<Node>& removedNodes) const {
+	if (useBitset()) {
+		return getComponentsFromScan(removedNodes);
+	}
 	vector<int> visitedList(numberOfNodes, 0);
 	for (set<Node>::iterator i = removedNodes.begin(); i != removedNodes.end(); ++i) {
 		Node v = *i;
@@ -392,6 +449,9 @@ vector<NodeSet> Graph::getComponents(const set<Node>& removedNodes) const {
 }
 
 vector<NodeSet> Graph::getComponents(const NodeSet& removedNodes) const {
+	if (useBitset()) {
+		return getComponentsFromScan(removedNodes);
+	}
 	vector<int> visitedList(numberOfNodes, 0);
 	for (Node v : removedNodes) {
 		if (!isValidNode(v)) {
@@ -440,6 +500,19 @@ vector<NodeSet> Graph::getComponentsAux(vector<int> visitedList, int numberOfUnh
 }
 
 bool Graph::isFullComponent(const vector<Node>& C, const vector<Node>& S) const {
+    if (useBitset()) {
+        // Every node in S must have a neighbor in C
+        vector<BitWord> component(adjacency.getWordsPerRow(), 0);
+        for (auto c: C) {
+            component[BITWORD_INDEX(c)] |= BITWORD_MASK(c);
+        }
+        for (auto s: S) {
+            if (!adjacency.rowIntersects(s, component.data())) {
+                return false;
+            }
+        }
+        return true;
+    }
     for (auto s: S) {
         bool has_neighbor = false;
         for (auto c: C) {
@@ -456,6 +529,22 @@ bool Graph::isFullComponent(const vector<Node>& C, const vector<Node>& S) const
 }
 
 vector<int> Graph::getComponentsMap(const vector<Node>& removedNodes) const {
+	if (useBitset()) {
+		ComponentScan scan;
+		if (!scanComponents(removedNodes, scan)) {
+			return vector<int>();
+		}
+		vector<int> componentsMap(numberOfNodes, 0);
+		for (Node v : removedNodes) {
+			componentsMap[v] = -1;
+		}
+		for (int i=0; i<scan.size(); ++i) {
+			for (Node v : scan.getComponent(i)) {
+				componentsMap[v] = i+1;
+			}
+		}
+		return componentsMap;
+	}
 	vector<int> visitedList(numberOfNodes, 0);
 	for (vector<Node>::const_iterator i = removedNodes.begin(); i != removedNodes.end(); ++i) {
 		Node v = *i;
@@ -539,6 +628,10 @@ NodeSet Graph::getAdjacent(const NodeSet& C, const NodeSet& K) const {
 }
 
 BlockVec Graph::getBlocks(const set<Node>& removedNodes) const {
+	if (useBitset()) {
+		ComponentScan scan;
+		return scanComponents(removedNodes, scan) ? getBlocksFromScan(scan) : BlockVec();
+	}
 	vector<int> visitedList(numberOfNodes, 0);
 	for (set<Node>::iterator i = removedNodes.begin(); i != removedNodes.end(); ++i) {
 		Node v = *i;
@@ -552,6 +645,10 @@ BlockVec Graph::getBlocks(const set<Node>& removedNodes) const {
 }
 
 BlockVec Graph::getBlocks(const NodeSet& removedNodes) const {
+	if (useBitset()) {
+		ComponentScan scan;
+		return scanComponents(removedNodes, scan) ? getBlocksFromScan(scan) : BlockVec();
+	}
 	vector<int> visitedList(numberOfNodes, 0);
 	for (Node v : removedNodes) {
 		if (!isValidNode(v)) {
@@ -600,10 +697,193 @@ BlockVec Graph::getBlocksAux(vector<int> visitedList, int numberOfUnhandeledNode
 				}
 			}
 		}
-		blocks.push_back(BlockPtr(new Block(sepProducer.produce(), compProducer.produce(),getNumberOfNodes())));
+		blocks.push_back(BlockPtr(new Block(sepProducer.produce(), compProducer.produce())));
+	}
+	return blocks;
+}
+BlockVec Graph::getBlocksFromScan(const ComponentScan& scan) const {
+	BlockVec blocks;
+	for (int i=0; i<scan.size(); ++i) {
+		blocks.push_back(BlockPtr(new Block(scan.getNeighborhood(i), scan.getComponent(i))));
 	}
 	return blocks;
 }
+
+ComponentScan::ComponentScan() :
+		wordsPerRow(0),
+		numberOfComponents(0),
+		numberOfRemovedNodes(0),
+		numberOfFullComponents(0) {}
+
+NodeSet ComponentScan::getComponent(int i) const {
+	NodeSet result;
+	result.reserve(componentSizes[i]);
+	bitwords_to_nodeset(component(i), wordsPerRow, result);
+	return result;
+}
+
+NodeSet ComponentScan::getNeighborhood(int i) const {
+	NodeSet result;
+	result.reserve(neighborhoodSizes[i]);
+	bitwords_to_nodeset(neighborhood(i), wordsPerRow, result);
+	return result;
+}
+
+bool Graph::scanComponents(const NodeSet& removedNodes, ComponentScan& scan) const {
+	return scanComponentsAux(removedNodes.begin(), removedNodes.end(), scan);
+}
+
+bool Graph::scanComponents(const set<Node>& removedNodes, ComponentScan& scan) const {
+	return scanComponentsAux(removedNodes.begin(), removedNodes.end(), scan);
+}
+
+/*
+ * Grows each component a whole BFS layer at a time: the next layer is the
+ * union of the rows of the current layer, masked by the nodes not yet
+ * reached. The removed nodes hit along the way form the neighborhood.
+ * Every row is read once per scan.
+ */
+template<class NodeIterator>
+bool Graph::scanComponentsAux(NodeIterator first, NodeIterator last, ComponentScan& scan,
+		bool stopAtFullComponent) const {
+	int W = adjacency.getWordsPerRow();
+	scan.wordsPerRow = W;
+	scan.numberOfComponents = 0;
+	scan.numberOfRemovedNodes = 0;
+	scan.numberOfFullComponents = 0;
+	scan.removed.assign(W, 0);
+	for (NodeIterator i = first; i != last; ++i) {
+		if (!isValidNode(*i)) {
+			scan.removed.assign(W, 0);
+			return false;
+		}
+		scan.removed[BITWORD_INDEX(*i)] |= BITWORD_MASK(*i);
+	}
+	// Start with all nodes that weren't removed
+	scan.remaining.assign(W, 0);
+	for (int w=0; w<W; ++w) {
+		int bits = min(BITWORD_BITS, numberOfNodes - w*BITWORD_BITS);
+		if (bits > 0) {
+			scan.remaining[w] = (bits == BITWORD_BITS ? ~BitWord(0) : BITWORD_MASK(bits)-1);
+		}
+		scan.remaining[w] &= ~scan.removed[w];
+		scan.numberOfRemovedNodes += bitword_count(scan.removed[w]);
+	}
+	scan.frontier.resize(W);
+	scan.reached.resize(W);
+
+	int seedWord = 0;
+	while (true) {
+		while (seedWord < W && scan.remaining[seedWord] == 0) {
+			seedWord++;
+		}
+		if (seedWord == W) {
+			break;
+		}
+		Node seed = seedWord*BITWORD_BITS + bitword_lowest(scan.remaining[seedWord]);
+		int c = scan.numberOfComponents++;
+		if (scan.components.size() < unsigned((c+1)*W)) {
+			scan.components.resize((c+1)*W);
+			scan.neighborhoods.resize((c+1)*W);
+			scan.componentSizes.resize(c+1);
+			scan.neighborhoodSizes.resize(c+1);
+		}
+		BitWord* C = &scan.components[c*W];
+		BitWord* S = &scan.neighborhoods[c*W];
+		std::fill(C, C+W, 0);
+		std::fill(S, S+W, 0);
+		std::fill(scan.frontier.begin(), scan.frontier.end(), 0);
+		C[BITWORD_INDEX(seed)] = BITWORD_MASK(seed);
+		scan.frontier[BITWORD_INDEX(seed)] = BITWORD_MASK(seed);
+		scan.remaining[BITWORD_INDEX(seed)] &= ~BITWORD_MASK(seed);
+		// BFS through the component, a layer at a time
+		bool grew = true;
+		while (grew) {
+			std::fill(scan.reached.begin(), scan.reached.end(), 0);
+			for (int w=0; w<W; ++w) {
+				for (BitWord f = scan.frontier[w]; f; f &= f-1) {
+					adjacency.orRow(w*BITWORD_BITS + bitword_lowest(f), scan.reached.data());
+				}
+			}
+			grew = false;
+			for (int w=0; w<W; ++w) {
+				S[w] |= scan.reached[w] & scan.removed[w];
+				BitWord added = scan.reached[w] & scan.remaining[w];
+				scan.remaining[w] &= ~added;
+				C[w] |= added;
+				scan.frontier[w] = added;
+				grew = grew || added;
+			}
+		}
+		int componentSize = 0, neighborhoodSize = 0;
+		for (int w=0; w<W; ++w) {
+			componentSize += bitword_count(C[w]);
+			neighborhoodSize += bitword_count(S[w]);
+		}
+		scan.componentSizes[c] = componentSize;
+		scan.neighborhoodSizes[c] = neighborhoodSize;
+		if (neighborhoodSize == scan.numberOfRemovedNodes) {
+			scan.numberOfFullComponents++;
+			if (stopAtFullComponent) {
+				break;
+			}
+		}
+	}
+	return true;
+}
+
+/*
+ * For each x in K, the nodes of K that x is connected to in the completed
+ * graph are its neighbors and the union of every component neighborhood
+ * containing x. All of K has to be covered, so this takes a single row
+ * comparison per node rather than a check per pair.
+ */
+bool Graph::isPotentialMaximalClique(const NodeSet& K, ComponentScan& scan) const {
+	if (!scanComponentsAux(K.begin(), K.end(), scan, true) ||
+			scan.numberOfFullComponents > 0) {
+		return false;
+	}
+	int W = scan.wordsPerRow;
+	BitWord* covered = scan.reached.data();
+	for (NodeSet::const_iterator i = K.begin(); i != K.end(); ++i) {
+		Node x = *i;
+		int xw = BITWORD_INDEX(x);
+		BitWord xbit = BITWORD_MASK(x);
+		const BitWord* N = adjacency.row(x);
+		for (int w=0; w<W; ++w) {
+			covered[w] = N[w];
+		}
+		covered[xw] |= xbit;
+		for (int c=0; c<scan.numberOfComponents; ++c) {
+			const BitWord* S = &scan.neighborhoods[c*W];
+			if (S[xw] & xbit) {
+				for (int w=0; w<W; ++w) {
+					covered[w] |= S[w];
+				}
+			}
+		}
+		for (int w=0; w<W; ++w) {
+			if (scan.removed[w] & ~covered[w]) {
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+template<class NodeContainer>
+vector<NodeSet> Graph::getComponentsFromScan(const NodeContainer& removedNodes) const {
+	ComponentScan scan;
+	if (!scanComponents(removedNodes, scan)) {
+		return vector<NodeSet>();
+	}
+	vector<NodeSet> components(scan.size());
+	for (int i=0; i<scan.size(); ++i) {
+		components[i] = scan.getComponent(i);
+	}
+	return components;
+}
+
 string Graph::str() const {
     ostringstream oss;
 	for (Node v=0; v<getNumberOfNodes(); v++) {
@@ -630,16 +910,9 @@ const NodeSet Block::getNodeSetUnion(const NodeSet& sep, const NodeSet& comp) {
 	return result;
 }
 
-const vector<bool> Block::getFullNodeVector(const NodeSet& nodes, int numNodes) {
-	vector<bool> result(numNodes, false);
-	for (auto n = nodes.begin(); n != nodes.end(); n++)
-		result[*n] = true;
-	return result;
-}
-
 bool Block::includesNodes(const NodeSet& toCheck) const {
 	for (auto n = toCheck.begin(); n != toCheck.end(); n++)
-		if (!fullNodes[*n])
+		if (!fullNodes.contains(*n))
 			return false;
 	return true;
 }
@@ -12,6 +12,58 @@ using namespace std;
 
 namespace tdenum {
 
+// Adjacency queries (areNeighbors, neighborhoods of node sets, full
+// component checks) can be answered either by the neighbor sets or by a
+// dense bit matrix kept alongside them. Both are always up to date; this
+// selects which one is read.
+typedef enum GraphAdjacencyBackend {
+    GRAPH_ADJACENCY_SETS,
+    GRAPH_ADJACENCY_BITSET
+} GraphAdjacencyBackend;
+extern int GRAPH_ADJACENCY_BACKEND;
+
+/*
+ * The connected components of a graph after removing a node set, as computed
+ * by Graph::scanComponents. Components are ordered by their smallest node.
+ * For every component C this holds C, its neighborhood S (the removed nodes
+ * adjacent to some node of C) and whether C is a full component (S is the
+ * entire removed set).
+ * Node sets are kept as rows of getWordsPerRow() bit words. Reusing the same
+ * instance for many scans avoids reallocating any of the buffers.
+ */
+class ComponentScan {
+	friend class Graph;
+	int wordsPerRow;
+	int numberOfComponents;
+	int numberOfRemovedNodes;
+	int numberOfFullComponents;
+	vector<BitWord> removed;
+	vector<BitWord> components;
+	vector<BitWord> neighborhoods;
+	vector<int> componentSizes;
+	vector<int> neighborhoodSizes;
+	// Scratch rows used during the scan
+	vector<BitWord> remaining;
+	vector<BitWord> frontier;
+	vector<BitWord> reached;
+public:
+	ComponentScan();
+	// Number of components found
+	int size() const { return numberOfComponents; }
+	int getWordsPerRow() const { return wordsPerRow; }
+	// The removed node set, the i'th component and its neighborhood as bit rows
+	const BitWord* getRemoved() const { return removed.data(); }
+	const BitWord* component(int i) const { return &components[i*wordsPerRow]; }
+	const BitWord* neighborhood(int i) const { return &neighborhoods[i*wordsPerRow]; }
+	int componentSize(int i) const { return componentSizes[i]; }
+	int neighborhoodSize(int i) const { return neighborhoodSizes[i]; }
+	bool isFull(int i) const { return neighborhoodSizes[i] == numberOfRemovedNodes; }
+	int getNumberOfFullComponents() const { return numberOfFullComponents; }
+	// The i'th component / neighborhood as sorted node sets
+	NodeSet getComponent(int i) const;
+	NodeSet getNeighborhood(int i) const;
+};
+
 /**
  * When using node renaming methods (sorting, random rename..) note
  * that graph structures (PMCs, separators) also have their names changed!
@@ -27,6 +79,10 @@ class Graph {
 	int numberOfNodes;
 	int numberOfEdges;
 	vector< set<Node> > neighborSets;
+	// Same edges as neighborSets, as a bit matrix
+	AdjacencyMatrix adjacency;
+	void rebuildAdjacency();
+	bool useBitset() const { return GRAPH_ADJACENCY_BACKEND == GRAPH_ADJACENCY_BITSET; }
 
 	// If the graph is randomized, update these
 	bool isRandomGraph;
@@ -43,6 +99,14 @@ class Graph {
 	bool isValidNode(Node v) const;
 	vector< vector<Node> > getComponentsAux(vector<int> visitedList, int numberOfUnhandeledNodes) const;
 	BlockVec getBlocksAux(vector<int> visitedList, int numberOfUnhandeledNodes) const;
+	template<class NodeIterator>
+	NodeSet getNeighborsBitset(NodeIterator first, NodeIterator last) const;
+	template<class NodeIterator>
+	bool scanComponentsAux(NodeIterator first, NodeIterator last, ComponentScan& scan,
+			bool stopAtFullComponent = false) const;
+	BlockVec getBlocksFromScan(const ComponentScan& scan) const;
+	template<class NodeContainer>
+	vector<NodeSet> getComponentsFromScan(const NodeContainer& removedNodes) const;
 
 	// Used by node renaming / sorting methods.
 	// nodeRenameAux returns a mapping from old names to new.
@@ -150,6 +214,17 @@ public:
 	// Returns the set of blocks of the given node set
 	BlockVec getBlocks(const set<Node>& removedNodes) const;
 	BlockVec getBlocks(const NodeSet& removedNodes) const;
+	// Finds the components of the graph after removing the given node set,
+	// along with their neighborhoods, in a single pass over the adjacency
+	// rows. Returns false (leaving the scan empty) if a removed node is
+	// invalid.
+	bool scanComponents(const NodeSet& removedNodes, ComponentScan& scan) const;
+	bool scanComponents(const set<Node>& removedNodes, ComponentScan& scan) const;
+	// Returns true <=> K is a potential maximal clique: no component of G\K
+	// is full, and every two nodes of K are adjacent or share the
+	// neighborhood of some component. The scan is used as a work area (it
+	// stops at the first full component, so may not hold all components).
+	bool isPotentialMaximalClique(const NodeSet& K, ComponentScan& scan) const;
 	// Prints the graph
 	string str() const;
 	void print() const;
@@ -312,11 +312,11 @@ GraphStats& GraphStats::add_trng(const ChordalGraph& t) {
     return *this;
 }
 GraphStats& GraphStats::increment_trng_count() { ++count_trng; return *this; }
-GraphStats& GraphStats::set_ms_calc_time(time_t t) { calc_time_ms = t; return *this; }
-GraphStats& GraphStats::set_pmc_calc_time(const PMCAlg& a, time_t t) { calc_time_by_alg_pmc[a] = t; return *this; }
-GraphStats& GraphStats::set_pmc_calc_time(const set<PMCAlg>& sa, time_t t) { for (PMCAlg a: sa) set_pmc_calc_time(a,t); return *this; }
-GraphStats& GraphStats::set_pmc_calc_time(const vector<PMCAlg>& va, time_t t) { for (PMCAlg a: va) set_pmc_calc_time(a,t); return *this; }
-GraphStats& GraphStats::set_trng_calc_time(time_t t) { calc_time_trng = t; return *this; }
+GraphStats& GraphStats::set_ms_calc_time(double t) { calc_time_ms = t; return *this; }
+GraphStats& GraphStats::set_pmc_calc_time(const PMCAlg& a, double t) { calc_time_by_alg_pmc[a] = t; return *this; }
+GraphStats& GraphStats::set_pmc_calc_time(const set<PMCAlg>& sa, double t) { for (PMCAlg a: sa) set_pmc_calc_time(a,t); return *this; }
+GraphStats& GraphStats::set_pmc_calc_time(const vector<PMCAlg>& va, double t) { for (PMCAlg a: va) set_pmc_calc_time(a,t); return *this; }
+GraphStats& GraphStats::set_trng_calc_time(double t) { calc_time_trng = t; return *this; }
 GraphStats& GraphStats::set_random() { g.declareRandom(get_p(), get_instance()); return *this; }
 GraphStats& GraphStats::unset_random() { g.derandomize(); return *this; }
 GraphStats& GraphStats::set_p(double prob) { g.declareRandom(prob, get_instance()); return *this; }
@@ -333,9 +333,9 @@ long GraphStats::get_ms_count() const { return (!has_nodes() ? 0 : count_ms.back
 long GraphStats::get_pmc_count() const { return count_pmc; }
 long GraphStats::get_trng_count() const { return count_trng; }
 vector<long> GraphStats::get_ms_subgraph_count() const { return count_ms; }
-time_t GraphStats::get_ms_calc_time() const { return calc_time_ms;}
-time_t GraphStats::get_trng_calc_time() const { return calc_time_trng; }
-time_t GraphStats::get_pmc_calc_time(const PMCAlg& a) const {
+double GraphStats::get_ms_calc_time() const { return calc_time_ms;}
+double GraphStats::get_trng_calc_time() const { return calc_time_trng; }
+double GraphStats::get_pmc_calc_time(const PMCAlg& a) const {
     if (calc_time_by_alg_pmc.find(a) == calc_time_by_alg_pmc.end()) {
         TRACE(TRACE_LVL__ERROR, "PMC not calculated using the algorithm '" << a << "'");
         return -1;
@@ -125,9 +125,10 @@ private:
     // The amount of time required for calculation the minimal separators.
     // Note: PMC calculation time may disregard the time required to calculate
     // the minimal separators of g (see actual_pmc_calc_time())
-    time_t calc_time_ms;
-    map<PMCAlg,time_t> calc_time_by_alg_pmc;
-    time_t calc_time_trng;
+    // Times are in seconds.
+    double calc_time_ms;
+    map<PMCAlg,double> calc_time_by_alg_pmc;
+    double calc_time_trng;
 
     // Data.
     // Minimal separators of all subgraphs may also be stored.
@@ -246,11 +247,11 @@ public:
     GraphStats& increment_ms_count();      // Adds 1 to the ms count
     GraphStats& add_trng(const ChordalGraph&);
     GraphStats& increment_trng_count();    // Adds 1 to the trng count
-    GraphStats& set_ms_calc_time(time_t);
-    GraphStats& set_pmc_calc_time(const PMCAlg&,time_t);
-    GraphStats& set_pmc_calc_time(const set<PMCAlg>&,time_t);   // Same time all algs
-    GraphStats& set_pmc_calc_time(const vector<PMCAlg>&,time_t);   // Same time all algs
-    GraphStats& set_trng_calc_time(time_t);
+    GraphStats& set_ms_calc_time(double);
+    GraphStats& set_pmc_calc_time(const PMCAlg&,double);
+    GraphStats& set_pmc_calc_time(const set<PMCAlg>&,double);   // Same time all algs
+    GraphStats& set_pmc_calc_time(const vector<PMCAlg>&,double);   // Same time all algs
+    GraphStats& set_trng_calc_time(double);
     GraphStats& set_random();
     GraphStats& unset_random();
     GraphStats& set_p(double);
@@ -270,9 +271,9 @@ public:
     vector<long> get_ms_subgraph_count() const;
     long get_pmc_count() const;
     long get_trng_count() const;
-    time_t get_ms_calc_time() const;
-    time_t get_pmc_calc_time(const PMCAlg&) const;
-    time_t get_trng_calc_time() const;
+    double get_ms_calc_time() const;
+    double get_pmc_calc_time(const PMCAlg&) const;
+    double get_trng_calc_time() const;
     NodeSetSet get_ms() const;
     NodeSetSet get_subgraph_ms(unsigned index) const;
     long get_ms_subgraph_count(unsigned index) const;
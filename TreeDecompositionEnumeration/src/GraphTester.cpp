@@ -1,5 +1,7 @@
 #include "GraphTester.h"
 #include "Graph.h"
+#include "SubGraph.h"
+#include <memory>
 
 namespace tdenum {
 
@@ -98,6 +100,136 @@ bool GraphTester::creating_random() const {
     return true;
 }
 
+// Queries g with both adjacency backends and compares the answers.
+static bool adjacency_backends_agree(const Graph& g) {
+    int backend = GRAPH_ADJACENCY_BACKEND;
+    bool agree = true;
+    int n = g.getNumberOfNodes();
+    vector<NodeSet> subsets;
+    for (int i=0; i<20; ++i) {
+        NodeSet s;
+        for (Node v=0; v<n; ++v) {
+            if (rand() % 5 == 0) {
+                s.push_back(v);
+            }
+        }
+        subsets.push_back(s);
+    }
+    vector<bool> answers[2];
+    vector<NodeSet> neighborhoods[2];
+    for (int b=0; b<2; ++b) {
+        GRAPH_ADJACENCY_BACKEND = (b ? GRAPH_ADJACENCY_BITSET : GRAPH_ADJACENCY_SETS);
+        for (Node u=0; u<n; ++u) {
+            for (Node v=0; v<n; ++v) {
+                answers[b].push_back(g.areNeighbors(u,v));
+            }
+            vector<bool> m = g.getNeighborsMap(u);
+            answers[b].insert(answers[b].end(), m.begin(), m.end());
+        }
+        for (unsigned i=0; i<subsets.size(); ++i) {
+            neighborhoods[b].push_back(g.getNeighbors(subsets[i]));
+            set<Node> asSet(subsets[i].begin(), subsets[i].end());
+            neighborhoods[b].push_back(g.getNeighbors(asSet));
+            for (auto C: g.getComponents(subsets[i])) {
+                answers[b].push_back(g.isFullComponent(C, subsets[i]));
+                neighborhoods[b].push_back(g.getAdjacent(C, subsets[i]));
+            }
+            for (auto B: g.getBlocks(subsets[i])) {
+                neighborhoods[b].push_back(B->S);
+                neighborhoods[b].push_back(B->C);
+                answers[b].push_back(B->S == subsets[i]);
+            }
+            neighborhoods[b].push_back(g.getComponentsMap(subsets[i]));
+        }
+    }
+    GRAPH_ADJACENCY_BACKEND = backend;
+    agree = (answers[0] == answers[1] && neighborhoods[0] == neighborhoods[1]);
+    if (!agree) {
+        TRACE(TRACE_LVL__ERROR, "Adjacency backends disagree on graph:" << endl << g);
+    }
+    return agree;
+}
+
+bool GraphTester::adjacency_backends() const {
+    // Cover the fixed row widths (1,2,4 words) and the dynamic one,
+    // including the word boundaries.
+    for (int n: {1, 10, 64, 65, 128, 130, 256, 300}) {
+        for (double p: {0.05, 0.3, 0.8}) {
+            SETUP(n);
+            g.randomize(p);
+            ASSERT(adjacency_backends_agree(g));
+            g.sortNodesByDegree(true);
+            ASSERT(adjacency_backends_agree(g));
+            g.randomNodeRename();
+            ASSERT(adjacency_backends_agree(g));
+            g.removeAllButFirstK((n+1)/2);
+            ASSERT(adjacency_backends_agree(g));
+            g.addEdge(0,(n-1)/2);
+            ASSERT(adjacency_backends_agree(g));
+        }
+    }
+    return true;
+}
+
+bool GraphTester::component_scan() const {
+    ComponentScan scan;
+    for (int n: {1, 10, 64, 65, 130, 300}) {
+        for (double p: {0.02, 0.1, 0.5}) {
+            SETUP(n);
+            g.randomize(p);
+            for (int i=0; i<10; ++i) {
+                NodeSet S;
+                for (Node v=0; v<n; ++v) {
+                    if (rand() % 4 == 0) {
+                        S.push_back(v);
+                    }
+                }
+                ASSERT(g.scanComponents(S, scan));
+                // Compare with a BFS over the neighbor sets
+                GRAPH_ADJACENCY_BACKEND = GRAPH_ADJACENCY_SETS;
+                BlockVec blocks = g.getBlocks(S);
+                GRAPH_ADJACENCY_BACKEND = GRAPH_ADJACENCY_BITSET;
+                ASSERT_EQ(scan.size(), int(blocks.size()));
+                int full = 0;
+                for (int j=0; j<scan.size(); ++j) {
+                    ASSERT_EQ(scan.getComponent(j), blocks[j]->C);
+                    ASSERT_EQ(scan.getNeighborhood(j), blocks[j]->S);
+                    ASSERT_EQ(scan.componentSize(j), int(blocks[j]->C.size()));
+                    ASSERT_EQ(scan.isFull(j), (blocks[j]->S == S));
+                    full += (blocks[j]->S == S);
+                }
+                ASSERT_EQ(scan.getNumberOfFullComponents(), full);
+            }
+        }
+    }
+    // Invalid nodes
+    SETUP(5);
+    ASSERT(!g.scanComponents(NodeSet({1,7}), scan));
+    ASSERT_EQ(scan.size(), 0);
+    return true;
+}
+
+bool GraphTester::prefix_subgraphs() const {
+    for (int n: {1, 5, 40, 70}) {
+        for (double p: {0.1, 0.5}) {
+            SETUP(n);
+            g.randomize(p);
+            NodeSet prefix({0});
+            std::unique_ptr<SubGraph> incremental(new SubGraph(g, prefix));
+            for (Node v=1; v<n; ++v) {
+                prefix.push_back(v);
+                std::unique_ptr<SubGraph> next(new SubGraph(*incremental, v));
+                SubGraph expected(SubGraph(g), prefix);
+                ASSERT_EQ(next->getNumberOfNodes(), expected.getNumberOfNodes());
+                ASSERT_EQ(next->getNumberOfEdges(), expected.getNumberOfEdges());
+                ASSERT(next->createEdgeSet() == expected.createEdgeSet());
+                ASSERT(SubGraph(g, prefix).createEdgeSet() == expected.createEdgeSet());
+                incremental = std::move(next);
+            }
+        }
+    }
+    return true;
+}
 
 GraphTester::GraphTester() :
     TestInterface("Graph Tester")
@@ -9,7 +9,10 @@ namespace tdenum {
 #define GRAPH_TEST_TABLE \
     X(sort_nodes_by_deg) \
     X(map_back_to_original) \
-    X(creating_random)
+    X(creating_random) \
+    X(adjacency_backends) \
+    X(component_scan) \
+    X(prefix_subgraphs)
 
 #define X(func) GRAPH_TEST_NAME__##func,
 typedef enum {
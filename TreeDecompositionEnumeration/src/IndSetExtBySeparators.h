@@ -52,6 +52,9 @@ public:
 
 	set<MinimalSeparator> extendToMaxIndependentSet(
 			const set<MinimalSeparator>& s) override;
+
+	// Only reads the graph
+	bool allowsConcurrentCalls() override { return true; }
 };
 }
 
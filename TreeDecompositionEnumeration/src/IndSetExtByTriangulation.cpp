@@ -18,4 +18,8 @@ set<MinimalSeparator> IndSetExtByTriangulation::extendToMaxIndependentSet(
 	return minimalSeparators;
 }
 
+bool IndSetExtByTriangulation::allowsConcurrentCalls() {
+	return triangulator.getHeuristic() != COMBINED;
+}
+
 } /* namespace tdenum */
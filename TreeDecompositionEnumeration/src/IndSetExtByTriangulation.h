@@ -20,6 +20,8 @@ class IndSetExtByTriangulation :
 public:
 	IndSetExtByTriangulation(const Graph& g, const MinimalTriangulator& t);
 	virtual set<MinimalSeparator> extendToMaxIndependentSet(const set<MinimalSeparator>& s);
+	// The combined heuristic alternates between the calls
+	virtual bool allowsConcurrentCalls();
 };
 
 } /* namespace tdenum */
@@ -24,6 +24,11 @@ public:
 	 * contains it.
 	 */
 	virtual set<T> extendToMaxIndependentSet(const set<T>& s) = 0;
+	/**
+	 * Returns true if extendToMaxIndependentSet may be called concurrently,
+	 * and its result depends only on the given set.
+	 */
+	virtual bool allowsConcurrentCalls() { return false; }
 };
 
 } /* namespace tdenum */
@@ -4,11 +4,17 @@
 #include "SuccinctGraphRepresentation.h"
 #include "IndependentSetExtender.h"
 #include "IndependentSetScorer.h"
+#include "DataStructures.h"
+#include "Utils.h"
+#include <omp.h>
 
 namespace tdenum {
 
 enum AlgorithmStep {BEGINNING, ITERATING_NODES, ITERATING_SETS};
 
+// Number of extensions per thread in a batch (see enable_parallel())
+#define MIS_PARALLEL_BATCH_PER_THREAD (4)
+
 /**
  * Enumerates the maximal independent sets of a graph given by a succinct graph
  * representation with an independent set expansion.
@@ -23,28 +29,80 @@ class MaximalIndependentSetsEnumerator {
 	IndependentSetExtender<T>& extender;
 	IndependentSetScorer<T>& scorer;
 
+	// Nodes are interned: the id of a node is its index in nodes. Nothing is
+	// removed from nodes, so the ids stay the same.
+	BasicNodeSetSet<T> nodes;
+	// Each independent set found is stored once, as the ids of its nodes in
+	// ascending order of the nodes. The id of a set is its index in sets.
+	NodeSetSet sets;
+	int numSetsNotExtended;
+
+	// Order ids by the nodes and sets they stand for, so that the containers
+	// holding ids are iterated in the order of the nodes and sets themselves
+	struct NodeOrder {
+		const MaximalIndependentSetsEnumerator* e;
+		bool operator()(int u, int v) const { return e->getNode(u) < e->getNode(v); }
+	};
+	struct SetOrder {
+		const MaximalIndependentSetsEnumerator* e;
+		bool operator()(int s, int t) const { return e->setLess(s, t); }
+	};
+	struct ScoredSetOrder {
+		const MaximalIndependentSetsEnumerator* e;
+		bool operator()(const pair<int, int>& s, const pair<int, int>& t) const {
+			if (s.first != t.first) {
+				return s.first < t.first;
+			}
+			return e->setLess(s.second, t.second);
+		}
+	};
+
 	// State
-	set<T> nodesGenerated;
-	set< set<T> > setsExtended;
-	set< set<T> > setsNotExtended;
-	set< pair<int, set<T> > > extendingQueue;
+	set<int, NodeOrder> nodesGenerated;
+	set<int, SetOrder> setsExtended;
+	set<pair<int, int>, ScoredSetOrder> extendingQueue;
 	bool nextSetReady;
-	set<T> nextIndependentSet;
+	int nextIndependentSet;
 	AlgorithmStep step;
 	// State for case ITERATING_NODES
-	typename set<T>::iterator nodesIterator;
-	set<T> currentSet;
+	typename set<int, NodeOrder>::iterator nodesIterator;
+	int currentSet;
 	// State for case ITERATING_SETS
-	typename set< set<T> >::iterator setsIterator;
-	T currentNode;
+	typename set<int, SetOrder>::iterator setsIterator;
+	int currentNode;
+	// Once cancelled, no more sets are generated
+	CancellationToken cancelToken;
+	// Parallel mode: the extensions of the next (set, node) pairs of the
+	// current loop are calculated together, and then consumed in order
+	bool parallel;
+	vector< pair<int, int> > batch;
+	vector< set<T> > batchResults;
+	unsigned int batchPosition;
 
+	int getNodeID(const T& node);
+	const T& getNode(int nodeID) const { return *(nodes.begin() + nodeID); }
+	const NodeSet& getSet(int setID) const { return *(sets.begin() + setID); }
+	set<T> getNodes(int setID) const;
+	// Compares the sets as sets of nodes
+	bool setLess(int s, int t) const;
 	void getNextSetToExtend();
-	set<T> extendSetInDirectionOfNode(const set<T>& set, const T& node);
+	set<T> getBaseNodes(int setID, int nodeID);
+	set<T> extendSetInDirectionOfNode(int setID, int nodeID);
+	bool useParallel();
+	bool isNextInBatch(int setID, int nodeID) const;
+	void extendBatch();
+	set<T> takeExtension(int setID, int nodeID);
+	// The extensions of the current pair of the loops below
+	set<T> extendCurrentSet();
+	set<T> extendInDirectionOfCurrentNode();
 	bool newSetFound(const set<T>& set);
 	bool runFullEnumeration();
 public:
 	MaximalIndependentSetsEnumerator(const MaximalIndependentSetsEnumerator& m) :
-		graph(m.graph), extender(m.extender), scorer(m.scorer){}
+		graph(m.graph), extender(m.extender), scorer(m.scorer),
+		numSetsNotExtended(0), nodesGenerated(NodeOrder{this}),
+		setsExtended(SetOrder{this}), extendingQueue(ScoredSetOrder{this}),
+		cancelToken(m.cancelToken), parallel(m.parallel), batchPosition(0){}
 	MaximalIndependentSetsEnumerator& operator=(const MaximalIndependentSetsEnumerator& a){return *this;}
 	/**
 	 * Initialization. Receives a succinct graph representation with an
@@ -60,38 +118,115 @@ public:
 	 * Returns another maximal independent set.
 	 */
 	set<T> next();
+	/**
+	 * Once the token is cancelled, hasNext() stops looking for new sets (it
+	 * checks between extensions) and returns false. A set that was already
+	 * found may still be returned.
+	 */
+	void setCancellationToken(const CancellationToken& token);
+	/**
+	 * In parallel mode, the extensions that hasNext() would try next are
+	 * calculated concurrently, in batches. The sets are found in the same
+	 * order as in sequential mode. Applies only if the extender allows
+	 * concurrent calls.
+	 */
+	MaximalIndependentSetsEnumerator& enable_parallel();
+	MaximalIndependentSetsEnumerator& suppress_parallel();
 };
 
 
 
+/**
+ * Returns the id of the given node, interning it if it's new.
+ */
+template<class T>
+int MaximalIndependentSetsEnumerator<T>::getNodeID(const T& node) {
+	typename BasicNodeSetSet<T>::iterator it = nodes.find(node);
+	if (it != nodes.end()) {
+		return it - nodes.begin();
+	}
+	nodes.insert(node);
+	return nodes.size() - 1;
+}
+
+
+template<class T>
+set<T> MaximalIndependentSetsEnumerator<T>::getNodes(int setID) const {
+	set<T> result;
+	const NodeSet& ids = getSet(setID);
+	for (NodeSet::const_iterator i=ids.begin(); i!=ids.end(); ++i) {
+		result.insert(result.end(), getNode(*i));
+	}
+	return result;
+}
+
+
+/*
+ * Lexicographic comparison, as for set< set<T> >. Equal ids stand for equal
+ * nodes, so the nodes are only compared at the first difference.
+ */
+template<class T>
+bool MaximalIndependentSetsEnumerator<T>::setLess(int s, int t) const {
+	const NodeSet& a = getSet(s);
+	const NodeSet& b = getSet(t);
+	unsigned int n = min(a.size(), b.size());
+	for (unsigned int i=0; i<n; ++i) {
+		if (a[i] != b[i]) {
+			return getNode(a[i]) < getNode(b[i]);
+		}
+	}
+	return a.size() < b.size();
+}
+
+
 /**
  * Saves the next set to extend to currentSet.
  */
 template<class T>
 void MaximalIndependentSetsEnumerator<T>::getNextSetToExtend() {
-	pair<int, set<T> > currentScoredSet = *extendingQueue.begin();
+	pair<int, int> currentScoredSet = *extendingQueue.begin();
 	if (scorer.mayScoreChange()) {
 		// Support for changing scores: Maybe choose a different set if the score has changed
-		int currentScore = scorer.scoreIndependentSet(currentScoredSet.second);
+		int currentScore = scorer.scoreIndependentSet(getNodes(currentScoredSet.second));
 		while (currentScore > currentScoredSet.first) {
 			// Update weight
-			pair<int, set<T> > rescoredSet = make_pair(currentScore, currentScoredSet.second);
+			pair<int, int> rescoredSet = make_pair(currentScore, currentScoredSet.second);
 			extendingQueue.erase(currentScoredSet);
 			extendingQueue.insert(rescoredSet);
 			// Choose new set
 			currentScoredSet = *extendingQueue.begin();
-			currentScore = scorer.scoreIndependentSet(currentScoredSet.second);
+			currentScore = scorer.scoreIndependentSet(getNodes(currentScoredSet.second));
 		}
 	}
 	currentSet = currentScoredSet.second;
 	// Update that this set is being extended
-	scorer.independentSetUsed(currentSet);
+	scorer.independentSetUsed(getNodes(currentSet));
 	setsExtended.insert(currentSet);
-	setsNotExtended.erase(currentSet);
+	numSetsNotExtended--;
 	extendingQueue.erase(currentScoredSet);
 }
 
 
+/*
+ * Input: maximal independent set and node.
+ * Returns the given node and the nodes from the given set that do not share an
+ * edge with the given node.
+ */
+template<class T>
+set<T> MaximalIndependentSetsEnumerator<T>::getBaseNodes(int setID, int nodeID) {
+	const T& node = getNode(nodeID);
+	set<T> baseNodes;
+	baseNodes.insert(node);
+	const NodeSet& s = getSet(setID);
+	for (NodeSet::const_iterator i=s.begin(); i!=s.end(); ++i) {
+		if (!graph.hasEdge(node, getNode(*i))) {
+			baseNodes.insert(getNode(*i));
+		}
+	}
+	return baseNodes;
+}
+
+
 /*
  * Input: maximal independent set and node.
  * Creates a maximal independent set containing the given node and the nodes
@@ -99,36 +234,125 @@ void MaximalIndependentSetsEnumerator<T>::getNextSetToExtend() {
  */
 template<class T>
 set<T> MaximalIndependentSetsEnumerator<T>::extendSetInDirectionOfNode(
-		const set<T>& s, const T& node) {
-	set<T> baseNodes;
-	baseNodes.insert(node);
-	for (typename set<T>::iterator i=s.begin(); i!=s.end(); ++i) {
-		if (!graph.hasEdge(node, *i)) {
-			baseNodes.insert(*i);
+		int setID, int nodeID) {
+	return extender.extendToMaxIndependentSet(getBaseNodes(setID, nodeID));
+}
+
+
+template<class T>
+bool MaximalIndependentSetsEnumerator<T>::useParallel() {
+	return parallel && extender.allowsConcurrentCalls();
+}
+
+
+template<class T>
+bool MaximalIndependentSetsEnumerator<T>::isNextInBatch(int setID, int nodeID) const {
+	return batchPosition < batch.size() && batch[batchPosition] == make_pair(setID, nodeID);
+}
+
+
+/*
+ * Extends the sets of the batch concurrently. The base sets are built first,
+ * so only the extender is called concurrently.
+ */
+template<class T>
+void MaximalIndependentSetsEnumerator<T>::extendBatch() {
+	vector< set<T> > baseSets(batch.size());
+	for (unsigned int i=0; i<batch.size(); ++i) {
+		baseSets[i] = getBaseNodes(batch[i].first, batch[i].second);
+	}
+	batchResults.assign(batch.size(), set<T>());
+	#pragma omp parallel for schedule(dynamic, 1)
+	for (long i=0; i<(long)batch.size(); ++i) {
+		if (!cancelToken.is_cancelled()) {
+			batchResults[i] = extender.extendToMaxIndependentSet(baseSets[i]);
+		}
+	}
+	batchPosition = 0;
+	// Some of the extensions may be missing
+	if (cancelToken.is_cancelled()) {
+		batch.clear();
+	}
+}
+
+
+/*
+ * Returns the extension of the given set in the direction of the given node,
+ * from the batch if it's the next one there.
+ */
+template<class T>
+set<T> MaximalIndependentSetsEnumerator<T>::takeExtension(int setID, int nodeID) {
+	if (isNextInBatch(setID, nodeID)) {
+		set<T> result;
+		result.swap(batchResults[batchPosition++]);
+		return result;
+	}
+	return extendSetInDirectionOfNode(setID, nodeID);
+}
+
+
+/*
+ * Extends currentSet in the direction of *nodesIterator. In parallel mode,
+ * the extensions in the direction of the following nodes are calculated with
+ * it.
+ */
+template<class T>
+set<T> MaximalIndependentSetsEnumerator<T>::extendCurrentSet() {
+	if (useParallel() && !isNextInBatch(currentSet, *nodesIterator)) {
+		unsigned int batchSize = MIS_PARALLEL_BATCH_PER_THREAD * omp_get_max_threads();
+		batch.clear();
+		for (typename set<int, NodeOrder>::iterator i = nodesIterator;
+				i != nodesGenerated.end() && batch.size() < batchSize; ++i) {
+			batch.push_back(make_pair(currentSet, *i));
 		}
+		extendBatch();
 	}
-	return extender.extendToMaxIndependentSet(baseNodes);
+	return takeExtension(currentSet, *nodesIterator);
+}
+
+
+/*
+ * Extends *setsIterator in the direction of currentNode. In parallel mode,
+ * the following sets are extended with it.
+ */
+template<class T>
+set<T> MaximalIndependentSetsEnumerator<T>::extendInDirectionOfCurrentNode() {
+	if (useParallel() && !isNextInBatch(*setsIterator, currentNode)) {
+		unsigned int batchSize = MIS_PARALLEL_BATCH_PER_THREAD * omp_get_max_threads();
+		batch.clear();
+		for (typename set<int, SetOrder>::iterator i = setsIterator;
+				i != setsExtended.end() && batch.size() < batchSize; ++i) {
+			batch.push_back(make_pair(*i, currentNode));
+		}
+		extendBatch();
+	}
+	return takeExtension(*setsIterator, currentNode);
 }
 
 
 /*
  * Input: maximal independent set.
- * If this set is new, it is inserted to setsNotExtended and extendingQueue,
- * and saved to nextIndependentSet.
+ * If this set is new, it is stored and inserted to extendingQueue, and its id
+ * is saved to nextIndependentSet.
  * Returns whether this set was new.
  */
 template<class T>
 bool MaximalIndependentSetsEnumerator<T>::newSetFound(const set<T>& generatedSet) {
-	if (setsExtended.find(generatedSet) == setsExtended.end()) {
-		pair<typename set< set<T> >::iterator, bool> insertionReturnValue = setsNotExtended.insert(generatedSet);
-		if (insertionReturnValue.second) {
-			extendingQueue.insert(make_pair(scorer.scoreIndependentSet(generatedSet), generatedSet));
-			nextIndependentSet = generatedSet;
-			nextSetReady = true;
-			return true;
-		}
+	NodeSet ids;
+	ids.reserve(generatedSet.size());
+	for (typename set<T>::const_iterator i=generatedSet.begin(); i!=generatedSet.end(); ++i) {
+		ids.push_back(getNodeID(*i));
 	}
-	return false;
+	if (sets.isMember(ids)) {
+		return false;
+	}
+	int setID = sets.size();
+	sets.insert(ids);
+	numSetsNotExtended++;
+	extendingQueue.insert(make_pair(scorer.scoreIndependentSet(generatedSet), setID));
+	nextIndependentSet = setID;
+	nextSetReady = true;
+	return true;
 }
 
 
@@ -138,19 +362,25 @@ bool MaximalIndependentSetsEnumerator<T>::runFullEnumeration() {
 		getNextSetToExtend();
 		for (nodesIterator = nodesGenerated.begin();
 				nodesIterator != nodesGenerated.end(); ++nodesIterator) {
-			set<T> generatedSet = extendSetInDirectionOfNode(currentSet, *nodesIterator);
+			if (cancelToken.is_cancelled()) {
+				return false;
+			}
+			set<T> generatedSet = extendCurrentSet();
 			if (newSetFound(generatedSet)) {
 				step = ITERATING_NODES;
 				return true;
 			}
 		}
-		while(setsNotExtended.empty() && graph.hasNextNode()) {
+		while(numSetsNotExtended == 0 && graph.hasNextNode()) {
 			// generate a new node and extend returned sets in this direction
-			currentNode = graph.nextNode();
+			currentNode = getNodeID(graph.nextNode());
 			nodesGenerated.insert(currentNode);
 			for (setsIterator = setsExtended.begin();
 					setsIterator != setsExtended.end(); ++setsIterator) {
-				set<T> generatedSet = extendSetInDirectionOfNode(*setsIterator, currentNode);
+				if (cancelToken.is_cancelled()) {
+					return false;
+				}
+				set<T> generatedSet = extendInDirectionOfCurrentNode();
 				if (newSetFound(generatedSet)) {
 					step = ITERATING_SETS;
 					return true;
@@ -168,7 +398,11 @@ bool MaximalIndependentSetsEnumerator<T>::runFullEnumeration() {
 template<class T>
 MaximalIndependentSetsEnumerator<T>::MaximalIndependentSetsEnumerator(
 		SuccinctGraphRepresentation<T>& g, IndependentSetExtender<T>& e,
-		IndependentSetScorer<T>& s) : graph(g), extender(e), scorer (s) {
+		IndependentSetScorer<T>& s) : graph(g), extender(e), scorer (s),
+		numSetsNotExtended(0), nodesGenerated(NodeOrder{this}),
+		setsExtended(SetOrder{this}), extendingQueue(ScoredSetOrder{this}),
+		nextSetReady(false), nextIndependentSet(-1), parallel(false),
+		batchPosition(0) {
 	newSetFound(extender.extendToMaxIndependentSet(set<T>()));
 	step = BEGINNING;
 }
@@ -186,18 +420,24 @@ bool MaximalIndependentSetsEnumerator<T>::hasNext() {
 			return runFullEnumeration();
 		} else if (step == ITERATING_NODES) {
 			for (; nodesIterator != nodesGenerated.end(); ++nodesIterator) {
-				set<T> generatedSet = extendSetInDirectionOfNode(currentSet, *nodesIterator);
+				if (cancelToken.is_cancelled()) {
+					return false;
+				}
+				set<T> generatedSet = extendCurrentSet();
 				if (newSetFound(generatedSet)) {
 					step = ITERATING_NODES;
 					return true;
 				}
 			}
-			while(setsNotExtended.empty() && graph.hasNextNode()) {
+			while(numSetsNotExtended == 0 && graph.hasNextNode()) {
 				// generate a new node and extend returned sets in this direction
-				currentNode = graph.nextNode();
+				currentNode = getNodeID(graph.nextNode());
 				nodesGenerated.insert(currentNode);
 				for (setsIterator = setsExtended.begin(); setsIterator != setsExtended.end(); ++setsIterator) {
-					set<T> generatedSet = extendSetInDirectionOfNode(*setsIterator, currentNode);
+					if (cancelToken.is_cancelled()) {
+						return false;
+					}
+					set<T> generatedSet = extendInDirectionOfCurrentNode();
 					if (newSetFound(generatedSet)) {
 						step = ITERATING_SETS;
 						return true;
@@ -207,18 +447,24 @@ bool MaximalIndependentSetsEnumerator<T>::hasNext() {
 			return runFullEnumeration();
 		} else if (step == ITERATING_SETS) {
 			for (; setsIterator != setsExtended.end(); ++setsIterator) {
-				set<T> generatedSet = extendSetInDirectionOfNode(*setsIterator, currentNode);
+				if (cancelToken.is_cancelled()) {
+					return false;
+				}
+				set<T> generatedSet = extendInDirectionOfCurrentNode();
 				if (newSetFound(generatedSet)) {
 					step = ITERATING_SETS;
 					return true;
 				}
 			}
-			while(setsNotExtended.empty() && graph.hasNextNode()) {
+			while(numSetsNotExtended == 0 && graph.hasNextNode()) {
 				// generate a new node and extend returned sets in this direction
-				currentNode = graph.nextNode();
+				currentNode = getNodeID(graph.nextNode());
 				nodesGenerated.insert(currentNode);
 				for (setsIterator = setsExtended.begin(); setsIterator != setsExtended.end(); ++setsIterator) {
-					set<T> generatedSet = extendSetInDirectionOfNode(*setsIterator, currentNode);
+					if (cancelToken.is_cancelled()) {
+						return false;
+					}
+					set<T> generatedSet = extendInDirectionOfCurrentNode();
 					if (newSetFound(generatedSet)) {
 						step = ITERATING_SETS;
 						return true;
@@ -233,6 +479,26 @@ bool MaximalIndependentSetsEnumerator<T>::hasNext() {
 }
 
 
+template<class T>
+void MaximalIndependentSetsEnumerator<T>::setCancellationToken(const CancellationToken& token) {
+	cancelToken = token;
+}
+
+
+template<class T>
+MaximalIndependentSetsEnumerator<T>& MaximalIndependentSetsEnumerator<T>::enable_parallel() {
+	parallel = true;
+	return *this;
+}
+
+
+template<class T>
+MaximalIndependentSetsEnumerator<T>& MaximalIndependentSetsEnumerator<T>::suppress_parallel() {
+	parallel = false;
+	return *this;
+}
+
+
 /*
  * Processes a maximal independent set that was not yet processed, transfers it
  * to the list of returned sets, and returns it.
@@ -241,7 +507,7 @@ template<class T>
 set<T> MaximalIndependentSetsEnumerator<T>::next() {
 	if (nextSetReady || hasNext()) {
 		nextSetReady = false;
-		return nextIndependentSet;
+		return getNodes(nextIndependentSet);
 	}
 	return set<T>();
 }
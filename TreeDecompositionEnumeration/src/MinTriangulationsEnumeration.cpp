@@ -1,13 +1,13 @@
 #include <iostream>
 #include <iomanip>
 #include <fstream>
-#include <ctime>
 #include <cstdlib>
 #include <string>
 #include "GraphReader.h"
 #include "MinimalTriangulationsEnumerator.h"
 #include "MinTriangulationsEnumeration.h"
 #include "ResultsHandler.h"
+#include "Utils.h"
 using namespace std;
 
 namespace tdenum {
@@ -72,11 +72,13 @@ void printSummary(ofstream& summaryOutput, InputFile& input, Graph& graph, bool
 using namespace tdenum;
 
 /**
- * First parameter is the graph file path. Second is timeout in seconds.
+ * First parameter is the graph file path. Second is timeout in seconds (may be
+ * fractional, a negative timeout means no limit).
  * Third is the order of extending triangulations. Options are: width, fill,
  * difference, sepsize, none.
  * Fourth is the order of extending minimal separators. Options are: size
  * (ascending), fill or none.
+ * parallel=true extends the independent sets of separators in parallel.
  */
 int main(int argc, char* argv[]) {
 	// Parse input graph file
@@ -88,13 +90,13 @@ int main(int argc, char* argv[]) {
 	Graph g = GraphReader::read(inputFile.getPath());
 
 	// Define default parameters
-	bool isTimeLimited = false;
-	int timeLimitInSeconds = -1;
+	double timeLimitInSeconds = -1;
 	WhenToPrint print = NEVER;
 	string algorithm = "";
 	TriangulationAlgorithm heuristic = MCS_M;
 	TriangulationScoringCriterion triangulationsOrder = NONE;
 	SeparatorsScoringCriterion separatorsOrder = UNIFORM;
+	bool parallel = false;
 
 	// Replace parameter specified
 	for (int i=2; i<argc; i++) {
@@ -102,10 +104,7 @@ int main(int argc, char* argv[]) {
 		string flagName = argument.substr(0, argument.find_last_of("="));
 		string flagValue = argument.substr(argument.find_last_of("=")+1);
 		if (flagName == "time_limit") {
-			timeLimitInSeconds = atoi(flagValue.c_str());
-			if (timeLimitInSeconds >= 0) {
-				isTimeLimited = true;
-			}
+			timeLimitInSeconds = atof(flagValue.c_str());
 		} else if (flagName == "print") {
 			if (flagValue == "all") {
 				print = ALWAYS;
@@ -164,6 +163,8 @@ int main(int argc, char* argv[]) {
 				cout << "Seperators scoring criterion not recognized" << endl;
 				return 0;
 			}
+		} else if (flagName == "parallel") {
+			parallel = (flagValue == "true");
 		}
 	}
 
@@ -188,17 +189,22 @@ int main(int argc, char* argv[]) {
 	cout << setprecision(2);
 	cout << "Starting enumeration for " << inputFile.getField() << "\\"
 			<< inputFile.getType() << "\\" << inputFile.getName() << endl;
-	clock_t startTime = clock();
+	Deadline deadline;
+	if (timeLimitInSeconds >= 0) {
+		deadline.set_strict_limit(timeLimitInSeconds);
+	}
 	ResultsHandler results(g, detailedOutput, print);
 	bool timeLimitExceeded = false;
 
 	// Generate the results and print details if asked for
 	MinimalTriangulationsEnumerator enumerator(g, triangulationsOrder, separatorsOrder, heuristic);
+	if (parallel) {
+		enumerator.enable_parallel();
+	}
 	while (enumerator.hasNext()) {
 		ChordalGraph triangulation = enumerator.next();
 		results.newResult(triangulation);
-		double totalTimeInSeconds = double(clock() - startTime) / CLOCKS_PER_SEC;
-		if (isTimeLimited && totalTimeInSeconds >= timeLimitInSeconds) {
+		if (deadline.expired_now()) {
 			timeLimitExceeded = true;
 			break;
 		}
@@ -208,7 +214,7 @@ int main(int argc, char* argv[]) {
 	}
 
 	// Print summary to file
-	double totalTimeInSeconds = double(clock() - startTime) / CLOCKS_PER_SEC;
+	double totalTimeInSeconds = deadline.elapsed();
 	int separators = enumerator.getNumberOfMinimalSeperatorsGenerated();
 	printSummary(summaryOutput, inputFile, g, timeLimitExceeded,
 			totalTimeInSeconds, algorithm, separators, results);
@@ -1,5 +1,6 @@
 #include "MinimalSeparatorsEnumerator.h"
-#include <ctime>
+#include "Utils.h"
+#include <omp.h>
 
 namespace tdenum {
 
@@ -7,16 +8,16 @@ namespace tdenum {
  * Initialization
  */
 MinimalSeparatorsEnumerator::MinimalSeparatorsEnumerator(const Graph& g, SeparatorsScoringCriterion c) :
-	graph(g), scorer(g,c) {
+	graph(g), scorer(g,c), parallel(false) {
 	// Initialize separatorsNotReturned according to the initialization phase
 	for (Node v = 0; v < g.getNumberOfNodes(); v++) {
 		set<Node> vAndNeighbors = graph.getNeighbors(v);
 		vAndNeighbors.insert(v);
-		BlockVec blocks = graph.getBlocks(vAndNeighbors);
-		for (auto it=blocks.begin(); it!=blocks.end(); ++it) {
-			if ((*it)->S.size() > 0) {
-				int score = scorer.scoreSeparator((*it)->S);
-				separatorsToExtend.insert((*it)->S, score);
+		graph.scanComponents(vAndNeighbors, scan);
+		for (int i=0; i<scan.size(); ++i) {
+			if (scan.neighborhoodSize(i) > 0) {
+				int score = scorer.scoreSeparator(scan.getNeighborhood(i));
+				separatorsToExtend.insert(SeparatorSet(scan.neighborhood(i), scan.getWordsPerRow()), score);
 			}
 		}
 	}
@@ -26,7 +27,7 @@ MinimalSeparatorsEnumerator::MinimalSeparatorsEnumerator(const Graph& g, Separat
  * Outputs whether there is a separator not yet returned.
  */
 bool MinimalSeparatorsEnumerator::hasNext() {
-	return !separatorsToExtend.isEmpty();
+	return !separatorsToExtend.isEmpty() && !cancelToken.is_cancelled();
 }
 
 /*
@@ -34,9 +35,9 @@ bool MinimalSeparatorsEnumerator::hasNext() {
  * If this separator was not found before, it is inserted to the set of not
  * returned separators.
  */
-void MinimalSeparatorsEnumerator::minimalSeparatorFound(const MinimalSeparator& s) {
-	if (s.size() > 0 && !separatorsExtended.isMember(s)) {
-		int score = scorer.scoreSeparator(s);
+void MinimalSeparatorsEnumerator::minimalSeparatorFound(const SeparatorSet& s) {
+	if (!s.empty() && !separatorsExtended.isMember(s)) {
+		int score = scorer.scoreSeparator(s.toNodeSet());
 		separatorsToExtend.insert(s, score);
 	}
 }
@@ -51,31 +52,121 @@ MinimalSeparator MinimalSeparatorsEnumerator::next() {
 		return MinimalSeparator();
 	}
 	// Choose separator and transfer to list of returned
-	MinimalSeparator s = separatorsToExtend.pop();
-	separatorsExtended.insert(s);
+	SeparatorSet sBits = separatorsToExtend.pop();
+	separatorsExtended.insert(sBits);
+	MinimalSeparator s = sBits.toNodeSet();
 	// Process separator according to the generation phase
-	for (MinimalSeparator::iterator i = s.begin(); i != s.end(); ++i) {
+	BasicNodeSetSet<SeparatorSet> found;
+	expandSeparator(s, scan, found);
+	for (auto it = found.begin(); it != found.end(); ++it) {
+		minimalSeparatorFound(*it);
+	}
+	return s;
+}
+
+/*
+ * The generation phase: for each x in s, the neighborhoods of the components
+ * of G\(N(x) U s) are minimal separators.
+ */
+void MinimalSeparatorsEnumerator::expandSeparator(const MinimalSeparator& s,
+		ComponentScan& scan, BasicNodeSetSet<SeparatorSet>& found) const {
+	for (MinimalSeparator::const_iterator i = s.begin(); i != s.end(); ++i) {
 		Node x = *i;
 		set<Node> xNeighborsAndS = graph.getNeighbors(x);
 		xNeighborsAndS.insert(s.begin(),s.end());
-		BlockVec blocks = graph.getBlocks(xNeighborsAndS);
-		for (auto j = blocks.begin(); j != blocks.end(); ++j) {
-			minimalSeparatorFound((*j)->S);
+		graph.scanComponents(xNeighborsAndS, scan);
+		for (int j=0; j<scan.size(); ++j) {
+			if (scan.neighborhoodSize(j) == 0) {
+				continue;
+			}
+			SeparatorSet sep(scan.neighborhood(j), scan.getWordsPerRow());
+			if (!separatorsExtended.isMember(sep)) {
+				found.insert(sep);
+			}
 		}
 	}
-	return s;
 }
 
-bool MinimalSeparatorsEnumerator::getAll(NodeSetSet& out, time_t limit) {
-    time_t t = time(NULL);
+MinimalSeparatorsEnumerator& MinimalSeparatorsEnumerator::enable_parallel() {
+	parallel = true;
+	return *this;
+}
+MinimalSeparatorsEnumerator& MinimalSeparatorsEnumerator::suppress_parallel() {
+	parallel = false;
+	return *this;
+}
+
+MinimalSeparatorsEnumerator& MinimalSeparatorsEnumerator::setCancellationToken(
+		const CancellationToken& token) {
+	cancelToken = token;
+	return *this;
+}
+
+bool MinimalSeparatorsEnumerator::getAll(NodeSetSet& out, double limit) {
+    return getAll(out, Deadline(limit));
+}
+
+bool MinimalSeparatorsEnumerator::getAll(NodeSetSet& out, const Deadline& deadline) {
+    if (parallel) {
+        return getAllParallel(out, deadline);
+    }
     while (hasNext()) {
         out.insert(next());
-        if (limit > 0 && difftime(time(NULL),t) > limit) {
+        if (deadline.expired()) {
             out = NodeSetSet();
             return false;
         }
     }
-    return true;
+    return !cancelToken.is_cancelled();
+}
+
+/*
+ * Separators waiting in the queue form the frontier. Each round moves the
+ * entire frontier to the extended set and expands its separators in
+ * parallel. Each thread collects new separators in its own set, and the sets
+ * are merged into the queue (which drops duplicates) after the round.
+ * Expansion only reads the graph and the extended set, neither of which
+ * changes during a round.
+ */
+#define MSE_PARALLEL_GRAIN (4)
+bool MinimalSeparatorsEnumerator::getAllParallel(NodeSetSet& out, const Deadline& deadline) {
+    AtomicFlag timed_out(false);
+    vector< BasicNodeSetSet<SeparatorSet> > found(omp_get_max_threads());
+    while (hasNext() && !timed_out) {
+        vector<MinimalSeparator> frontier;
+        while (hasNext()) {
+            SeparatorSet sBits = separatorsToExtend.pop();
+            separatorsExtended.insert(sBits);
+            frontier.push_back(sBits.toNodeSet());
+            out.insert(frontier.back());
+        }
+        #pragma omp parallel
+        {
+            ComponentScan localScan;
+            #pragma omp for schedule(dynamic, MSE_PARALLEL_GRAIN)
+            for (long k=0; k<(long)frontier.size(); ++k) {
+                if (timed_out || cancelToken.is_cancelled()) {
+                    continue;
+                }
+                if (deadline.expired()) {
+                    timed_out = true;
+                    continue;
+                }
+                expandSeparator(frontier[k], localScan, found[omp_get_thread_num()]);
+            }
+        }
+        for (unsigned i=0; i<found.size(); ++i) {
+            for (auto it = found[i].begin(); it != found[i].end(); ++it) {
+                minimalSeparatorFound(*it);
+            }
+            found[i].clear();
+        }
+    }
+    if (timed_out) {
+        out = NodeSetSet();
+        return false;
+    }
+    return !cancelToken.is_cancelled();
 }
 
 } /* namespace tdenum */
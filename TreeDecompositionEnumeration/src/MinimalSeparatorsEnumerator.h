@@ -4,6 +4,7 @@
 #include "Graph.h"
 #include "SeparatorsScorer.h"
 #include "DataStructures.h"
+#include "Utils.h"
 
 namespace tdenum {
 
@@ -15,11 +16,26 @@ namespace tdenum {
  * A. Berry, J. P. Bordat, and O. Cogis, 1999.
  */
 class MinimalSeparatorsEnumerator {
+	// Separators are kept as bitsets internally, and only converted to
+	// NodeSets when returned or scored.
+	typedef DynamicNodeBitSet SeparatorSet;
 	Graph graph;
 	SeparatorsScorer scorer;
-	WeightedNodeSetQueue separatorsToExtend;
-	NodeSetSet separatorsExtended;
-	void minimalSeparatorFound(const MinimalSeparator& s);
+	BasicWeightedNodeSetQueue<SeparatorSet> separatorsToExtend;
+	BasicNodeSetSet<SeparatorSet> separatorsExtended;
+	// Reused for every component computation
+	ComponentScan scan;
+	// If true, getAll() expands separators in parallel
+	bool parallel;
+	// Once cancelled, there are no more separators
+	CancellationToken cancelToken;
+	void minimalSeparatorFound(const SeparatorSet& s);
+	// Adds the separators generated from s to found (as long as they weren't
+	// extended yet). Doesn't modify the enumerator, so it may be called
+	// concurrently with different scan / found arguments.
+	void expandSeparator(const MinimalSeparator& s, ComponentScan& scan,
+			BasicNodeSetSet<SeparatorSet>& found) const;
+	bool getAllParallel(NodeSetSet& out, const Deadline& deadline);
 public:
 	// Initialization
 	MinimalSeparatorsEnumerator(const Graph& g, SeparatorsScoringCriterion c);
@@ -28,9 +44,21 @@ public:
 	// Returns another minimal separator
 	MinimalSeparator next();
 	// Returns all minimal separators as a NodeSetSet.
-	// If a non-zero time limit is given and the algorithm takes too long,
-	// returns false and sets the output to an empty NodeSetSet.
-	bool getAll(NodeSetSet& out, time_t limit = 0);
+	// If a non-zero time limit (in seconds) is given and the algorithm takes
+	// too long, returns false and sets the output to an empty NodeSetSet.
+	// The same goes if the given deadline expires (or is cancelled).
+	// If the enumerator's own token is cancelled, returns false, but the
+	// output keeps the separators found so far.
+	// If parallel mode is enabled, all separators waiting to be extended are
+	// expanded concurrently, round by round. The resulting set is the same.
+	bool getAll(NodeSetSet& out, double limit = 0);
+	bool getAll(NodeSetSet& out, const Deadline& deadline);
+	// Parallel mode only affects getAll(); hasNext() and next() remain
+	// sequential.
+	MinimalSeparatorsEnumerator& enable_parallel();
+	MinimalSeparatorsEnumerator& suppress_parallel();
+	// After the token is cancelled hasNext() returns false.
+	MinimalSeparatorsEnumerator& setCancellationToken(const CancellationToken& token);
 };
 
 } /* namespace tdenum */
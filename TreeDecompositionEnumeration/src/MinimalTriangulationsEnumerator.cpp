@@ -36,6 +36,30 @@ int MinimalTriangulationsEnumerator::getNumberOfMinimalSeperatorsGenerated() {
 	return separatorGraph.getNumberOfNodesGenerated();
 }
 
+void MinimalTriangulationsEnumerator::setCancellationToken(const CancellationToken& token) {
+	setsEnumerator.setCancellationToken(token);
+}
+
+MinimalTriangulationsEnumerator& MinimalTriangulationsEnumerator::enable_parallel() {
+	setsEnumerator.enable_parallel();
+	return *this;
+}
+
+MinimalTriangulationsEnumerator& MinimalTriangulationsEnumerator::suppress_parallel() {
+	setsEnumerator.suppress_parallel();
+	return *this;
+}
+
+MinimalTriangulationsEnumerator& MinimalTriangulationsEnumerator::enable_crossing_matrix() {
+	separatorGraph.enable_crossing_matrix();
+	return *this;
+}
+
+MinimalTriangulationsEnumerator& MinimalTriangulationsEnumerator::suppress_crossing_matrix() {
+	separatorGraph.suppress_crossing_matrix();
+	return *this;
+}
+
 vector<ChordalGraph> MinimalTriangulationsEnumerator::getAll() {
     vector<ChordalGraph> vcg;
     while(hasNext()) {
@@ -7,6 +7,7 @@
 #include "IndSetExtBySeparators.h"
 #include "MaximalIndependentSetsEnumerator.h"
 #include "IndSetScorerByTriangulation.h"
+#include "Utils.h"
 
 namespace tdenum {
 
@@ -31,6 +32,17 @@ public:
 	ChordalGraph next();
 	// Returns the number of minimal separators generated
 	int getNumberOfMinimalSeperatorsGenerated();
+	// Once the token is cancelled, hasNext() returns false (see
+	// MaximalIndependentSetsEnumerator).
+	void setCancellationToken(const CancellationToken& token);
+	// Extends the independent sets in parallel (see
+	// MaximalIndependentSetsEnumerator::enable_parallel())
+	MinimalTriangulationsEnumerator& enable_parallel();
+	MinimalTriangulationsEnumerator& suppress_parallel();
+	// Checks crossing separators using a precalculated matrix once all of
+	// them were generated (see SeparatorGraph::enable_crossing_matrix())
+	MinimalTriangulationsEnumerator& enable_crossing_matrix();
+	MinimalTriangulationsEnumerator& suppress_crossing_matrix();
 	// Get all triangulations, return them in an ordered vector.
 	// After calling getAll(), hasNext() should return false.
 	vector<ChordalGraph> getAll();
@@ -0,0 +1,356 @@
+#include "DirectoryIterator.h"
+#include "GraphReader.h"
+#include "MinimalTriangulationsEnumerator.h"
+#include "MinimalTriangulationsTester.h"
+#include <omp.h>
+
+namespace tdenum {
+
+// The subgraph induced by the first k nodes
+static Graph first_nodes_subgraph(const Graph& g, int k) {
+    Graph sub(k);
+    for (Node v=0; v<k; ++v) {
+        const set<Node>& neighbors = g.getNeighbors(v);
+        for (auto u = neighbors.begin(); u != neighbors.end() && *u < k; ++u) {
+            sub.addEdge(*u, v);
+        }
+    }
+    return sub;
+}
+
+// The DBPedia graphs, and the first 12 or 14 nodes of the easy random graphs
+static bool read_graphs(vector<Graph>& graphs) {
+    string filename;
+    DirectoryIterator di(DATASET_DIR_BASE+DATASET_DIR_DEADEASY+"DBPedia");
+    while (di.next_file(filename)) {
+        graphs.push_back(GraphReader::read(filename));
+        ASSERT(!GraphReader::last_read_failed());
+    }
+    for (string p : {"30", "50", "70"}) {
+        Graph g = GraphReader::read(DATASET_DIR_BASE+DATASET_DIR_EASY+
+                                    "Probability"+p+"percent"+SLASH+"20.csv");
+        ASSERT(!GraphReader::last_read_failed());
+        graphs.push_back(first_nodes_subgraph(g, 12));
+        if (p != "30") {
+            graphs.push_back(first_nodes_subgraph(g, 14));
+        }
+    }
+    return true;
+}
+
+// The easy random graphs, and the first 100 nodes of a Promedas graph (more
+// nodes than a single bit word holds)
+static bool read_large_graphs(vector<Graph>& graphs) {
+    for (string p : {"30", "50", "70"}) {
+        graphs.push_back(GraphReader::read(DATASET_DIR_BASE+DATASET_DIR_EASY+
+                                           "Probability"+p+"percent"+SLASH+"20.csv"));
+        ASSERT(!GraphReader::last_read_failed());
+    }
+    Graph g = GraphReader::read(DATASET_DIR_BASE+DATASET_DIR_DEADEASY+"BN"+SLASH+
+                                "Promedas"+SLASH+"or_chain_154.fg.uai");
+    ASSERT(!GraphReader::last_read_failed());
+    graphs.push_back(first_nodes_subgraph(g, 100));
+    return true;
+}
+
+// The graphs have far fewer minimal triangulations. Stops a faulty
+// enumeration that keeps returning results.
+#define MINIMALTRIANGULATIONSTESTER_MAX_RESULTS (1000)
+
+// The parallel extensions only pay off with more than one thread
+#define MINIMALTRIANGULATIONSTESTER_THREADS (4)
+
+MinimalTriangulationsTester::MinimalTriangulationsTester() :
+    TestInterface("Minimal Triangulations Tester")
+    #define X(test) , flag_##test(true)
+    MINIMALTRIANGULATIONSTESTER_TEST_TABLE
+    #undef X
+    {}
+
+MinimalTriangulationsTester& MinimalTriangulationsTester::go() {
+    if ((graphs.empty() && !read_graphs(graphs)) ||
+        (largeGraphs.empty() && !read_large_graphs(largeGraphs))) {
+        failed = true;
+        return *this;
+    }
+    #define X(test) if (flag_##test) {DO_TEST(test);}
+    MINIMALTRIANGULATIONSTESTER_TEST_TABLE
+    #undef X
+    return *this;
+}
+
+// Setters / getters
+#define X(test) \
+MinimalTriangulationsTester& MinimalTriangulationsTester::set_##test() { flag_##test = true; return *this; } \
+MinimalTriangulationsTester& MinimalTriangulationsTester::unset_##test() { flag_##test = false; return *this; } \
+MinimalTriangulationsTester& MinimalTriangulationsTester::set_only_##test() { clear_all(); return set_##test(); }
+MINIMALTRIANGULATIONSTESTER_TEST_TABLE
+#undef X
+
+MinimalTriangulationsTester& MinimalTriangulationsTester::set_all() {
+    #define X(test) set_##test();
+    MINIMALTRIANGULATIONSTESTER_TEST_TABLE
+    #undef X
+    return *this;
+}
+MinimalTriangulationsTester& MinimalTriangulationsTester::clear_all() {
+    #define X(test) unset_##test();
+    MINIMALTRIANGULATIONSTESTER_TEST_TABLE
+    #undef X
+    return *this;
+}
+
+// The maximal independent sets of the separator graph, in the order they are
+// returned
+static bool independent_sets(const Graph& g, TriangulationAlgorithm heuristic,
+                             bool parallel, vector< set<MinimalSeparator> >& sets) {
+    SeparatorGraph separatorGraph(g, UNIFORM);
+    MinimalTriangulator triangulator(heuristic);
+    IndSetExtByTriangulation triExtender(g, triangulator);
+    IndSetExtBySeparators sepExtender(g);
+    IndSetScorerByTriangulation scorer(g, NONE);
+    IndependentSetExtender<MinimalSeparator>* extender = &triExtender;
+    if (heuristic == SEPARATORS) {
+        extender = &sepExtender;
+    }
+    MaximalIndependentSetsEnumerator<MinimalSeparator> enumerator(separatorGraph, *extender, scorer);
+    if (parallel) {
+        enumerator.enable_parallel();
+    }
+    while (enumerator.hasNext()) {
+        ASSERT_LESS(int(sets.size()), MINIMALTRIANGULATIONSTESTER_MAX_RESULTS);
+        sets.push_back(enumerator.next());
+    }
+    return true;
+}
+
+// The minimal triangulations, in the order they are returned
+static bool triangulations(const Graph& g, TriangulationAlgorithm heuristic,
+                           bool parallel, vector<ChordalGraph>& results) {
+    MinimalTriangulationsEnumerator enumerator(g, NONE, UNIFORM, heuristic);
+    if (parallel) {
+        enumerator.enable_parallel();
+    }
+    while (enumerator.hasNext()) {
+        ASSERT_LESS(int(results.size()), MINIMALTRIANGULATIONSTESTER_MAX_RESULTS);
+        results.push_back(enumerator.next());
+    }
+    return true;
+}
+
+// In parallel mode the sets should be found, and returned, in the same order
+// as in sequential mode
+bool MinimalTriangulationsTester::parallel_independent_sets() {
+    int threads = omp_get_max_threads();
+    omp_set_num_threads(MINIMALTRIANGULATIONSTESTER_THREADS);
+    bool success = true;
+    for (unsigned i=0; success && i<graphs.size(); ++i) {
+        for (TriangulationAlgorithm heuristic : {MCS_M, MIN_FILL_LB_TRIANG, SEPARATORS}) {
+            vector< set<MinimalSeparator> > sequential, parallel;
+            success = independent_sets(graphs[i], heuristic, false, sequential) &&
+                      independent_sets(graphs[i], heuristic, true, parallel);
+            if (!success || sequential != parallel) {
+                TRACE(TRACE_LVL__ALWAYS, "Graph " << i << ", heuristic " << heuristic
+                      << ": " << sequential.size() << " sets in sequential mode, "
+                      << parallel.size() << " sets in parallel mode");
+                success = false;
+                break;
+            }
+        }
+    }
+    omp_set_num_threads(threads);
+    return success;
+}
+
+bool MinimalTriangulationsTester::parallel_triangulations() {
+    int threads = omp_get_max_threads();
+    omp_set_num_threads(MINIMALTRIANGULATIONSTESTER_THREADS);
+    bool success = true;
+    for (unsigned i=0; success && i<graphs.size(); ++i) {
+        for (TriangulationAlgorithm heuristic : {MCS_M, MIN_FILL_LB_TRIANG, SEPARATORS}) {
+            vector<ChordalGraph> sequential, parallel;
+            success = triangulations(graphs[i], heuristic, false, sequential) &&
+                      triangulations(graphs[i], heuristic, true, parallel) &&
+                      sequential.size() == parallel.size();
+            for (unsigned j=0; success && j<sequential.size(); ++j) {
+                success = (sequential[j] == parallel[j]);
+            }
+            if (!success) {
+                TRACE(TRACE_LVL__ALWAYS, "Graph " << i << ", heuristic " << heuristic
+                      << ": " << sequential.size() << " triangulations in sequential mode, "
+                      << parallel.size() << " triangulations in parallel mode");
+                break;
+            }
+        }
+    }
+    omp_set_num_threads(threads);
+    return success;
+}
+
+// Two minimal separators cross if the nodes of one of them are in different
+// components of the graph without the other
+static bool crossing(const Graph& g, const MinimalSeparator& s, const MinimalSeparator& t) {
+    vector<int> componentsMap = g.getComponentsMap(s);
+    set<int> components;
+    for (Node v : t) {
+        if (componentsMap[v] != -1) {
+            components.insert(componentsMap[v]);
+        }
+    }
+    return components.size() > 1;
+}
+
+// hasEdge() should agree with the components of the graph, both while the
+// separators are generated and after all of them were. Each pair is checked
+// twice, to check the component maps cached by the first round.
+bool MinimalTriangulationsTester::separator_graph_aux(bool matrix, int capacity) {
+    for (unsigned i=0; i<graphs.size(); ++i) {
+        const Graph& g = graphs[i];
+        SeparatorGraph separatorGraph(g, UNIFORM);
+        if (matrix) {
+            separatorGraph.enable_crossing_matrix();
+        }
+        vector<MinimalSeparator> separators;
+        while (separatorGraph.hasNextNode()) {
+            MinimalSeparator s = separatorGraph.nextNode();
+            for (const MinimalSeparator& t : separators) {
+                ASSERT_EQ(separatorGraph.hasEdge(s, t), crossing(g, s, t));
+                ASSERT_EQ(separatorGraph.hasEdge(t, s), crossing(g, t, s));
+            }
+            separators.push_back(s);
+        }
+        for (int round=0; round<2; ++round) {
+            if (capacity >= 0 && round == 1) {
+                separatorGraph.setCacheCapacity(capacity);
+            }
+            for (const MinimalSeparator& s : separators) {
+                for (const MinimalSeparator& t : separators) {
+                    ASSERT_EQ(separatorGraph.hasEdge(s, t), crossing(g, s, t));
+                }
+            }
+        }
+    }
+    return true;
+}
+
+bool MinimalTriangulationsTester::separator_graph_no_matrix() {
+    return separator_graph_aux(false, -1);
+}
+bool MinimalTriangulationsTester::separator_graph_crossing_matrix() {
+    return separator_graph_aux(true, -1);
+}
+// Shrinking the cache drops the least recently used maps. A capacity of 0
+// keeps no map between calls.
+bool MinimalTriangulationsTester::separator_graph_small_cache() {
+    for (int capacity : {0, 1, 2}) {
+        ASSERT(separator_graph_aux(false, capacity));
+    }
+    return true;
+}
+
+// The number of pairs of neighbors of v that are not adjacent
+static int count_fill(const Graph& g, Node v) {
+    const set<Node>& neighbors = g.getNeighbors(v);
+    int fill = 0;
+    for (auto u = neighbors.begin(); u != neighbors.end(); ++u) {
+        for (auto w = next(u); w != neighbors.end(); ++w) {
+            if (!g.areNeighbors(*u, *w)) {
+                ++fill;
+            }
+        }
+    }
+    return fill;
+}
+
+// The minimal separators of g included in the neighborhood of v in gi
+static set<NodeSet> substars(const Graph& g, const Graph& gi, Node v) {
+    set<Node> removedNodes = gi.getNeighbors(v);
+    removedNodes.insert(v);
+    vector<NodeSet> components = g.getComponents(removedNodes);
+    set<NodeSet> result;
+    for (const NodeSet& component : components) {
+        result.insert(g.getNeighbors(component));
+    }
+    return result;
+}
+
+// LB-Triang with a fill heuristic, counting the fill from scratch. Ties are
+// broken by the smaller node. The fill of the next node is updated (until it
+// doesn't grow) unless only the initial fill is used.
+static ChordalGraph lb_triang_by_fill(const Graph& g, bool initialFill) {
+    Graph result(g);
+    set< pair<int,Node> > queue;
+    for (Node v=0; v<g.getNumberOfNodes(); ++v) {
+        queue.insert(make_pair(count_fill(result, v), v));
+    }
+    while (!queue.empty()) {
+        while (!initialFill && count_fill(result, queue.begin()->second) > queue.begin()->first) {
+            Node v = queue.begin()->second;
+            queue.erase(queue.begin());
+            queue.insert(make_pair(count_fill(result, v), v));
+        }
+        Node v = queue.begin()->second;
+        queue.erase(queue.begin());
+        result.saturateNodeSets(substars(g, result, v));
+    }
+    return result;
+}
+
+// The fill the tracker keeps should be the fill of the graph after each
+// saturation. The substars of every node (in the input graph) are saturated,
+// followed by random node sets.
+bool MinimalTriangulationsTester::fill_tracker_saturation() {
+    vector<Graph> allGraphs(graphs);
+    allGraphs.insert(allGraphs.end(), largeGraphs.begin(), largeGraphs.end());
+    for (unsigned i=0; i<allGraphs.size(); ++i) {
+        Graph g = allGraphs[i];
+        int n = g.getNumberOfNodes();
+        FillTracker tracker(g);
+        vector< set<NodeSet> > saturated;
+        for (Node v=0; v<n; ++v) {
+            saturated.push_back(substars(allGraphs[i], g, v));
+        }
+        for (int j=0; j<10; ++j) {
+            NodeSet nodes;
+            for (Node v=0; v<n; ++v) {
+                if (rand() % 4 == 0) {
+                    nodes.push_back(v);
+                }
+            }
+            saturated.push_back(set<NodeSet>());
+            saturated.back().insert(nodes);
+        }
+        for (Node v=0; v<n; ++v) {
+            ASSERT_EQ(tracker.getFill(v), count_fill(g, v));
+        }
+        for (unsigned j=0; j<saturated.size(); ++j) {
+            g.saturateNodeSets(saturated[j]);
+            tracker.saturateNodeSets(saturated[j]);
+            for (Node v=0; v<n; ++v) {
+                ASSERT_EQ(tracker.getFill(v), count_fill(g, v));
+            }
+        }
+    }
+    return true;
+}
+
+// The fill heuristics should give the triangulations found by counting the
+// fill from scratch. The combined heuristic alternates between min-fill
+// LB-Triang and MCS-M.
+bool MinimalTriangulationsTester::fill_heuristics_triangulations() {
+    vector<Graph> allGraphs(graphs);
+    allGraphs.insert(allGraphs.end(), largeGraphs.begin(), largeGraphs.end());
+    for (unsigned i=0; i<allGraphs.size(); ++i) {
+        const Graph& g = allGraphs[i];
+        ChordalGraph minFill = lb_triang_by_fill(g, false);
+        ChordalGraph initialFill = lb_triang_by_fill(g, true);
+        ASSERT(MinimalTriangulator(MIN_FILL_LB_TRIANG).triangulate(g) == minFill);
+        ASSERT(MinimalTriangulator(INITIAL_FILL_LB_TRIANG).triangulate(g) == initialFill);
+        MinimalTriangulator combined(COMBINED);
+        ASSERT(combined.triangulate(g) == minFill);
+        ASSERT(combined.triangulate(g) == MinimalTriangulator(MCS_M).triangulate(g));
+    }
+    return true;
+}
+
+}
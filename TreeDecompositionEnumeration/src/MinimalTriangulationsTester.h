@@ -0,0 +1,48 @@
+#ifndef MINIMALTRIANGULATIONSTESTER_H_INCLUDED
+#define MINIMALTRIANGULATIONSTESTER_H_INCLUDED
+
+#include "Graph.h"
+#include "TestInterface.h"
+
+namespace tdenum {
+
+#define MINIMALTRIANGULATIONSTESTER_TEST_TABLE \
+    X(parallel_independent_sets) \
+    X(parallel_triangulations) \
+    X(separator_graph_no_matrix) \
+    X(separator_graph_crossing_matrix) \
+    X(separator_graph_small_cache) \
+    X(fill_tracker_saturation) \
+    X(fill_heuristics_triangulations)
+
+class MinimalTriangulationsTester : public TestInterface {
+private:
+
+    // Small graphs from the datasets
+    vector<Graph> graphs;
+    // Graphs with too many minimal triangulations to enumerate
+    vector<Graph> largeGraphs;
+
+    // A negative cache capacity keeps the default
+    bool separator_graph_aux(bool matrix, int capacity);
+
+    #define X(test) bool flag_##test;
+    MINIMALTRIANGULATIONSTESTER_TEST_TABLE
+    #undef X
+    MinimalTriangulationsTester& go();
+public:
+    MinimalTriangulationsTester();
+    #define X(test) \
+    MinimalTriangulationsTester& set_##test(); \
+    MinimalTriangulationsTester& unset_##test(); \
+    MinimalTriangulationsTester& set_only_##test(); \
+    bool test();
+    MINIMALTRIANGULATIONSTESTER_TEST_TABLE
+    #undef X
+    MinimalTriangulationsTester& set_all();
+    MinimalTriangulationsTester& clear_all();
+};
+
+}
+
+#endif // MINIMALTRIANGULATIONSTESTER_H_INCLUDED
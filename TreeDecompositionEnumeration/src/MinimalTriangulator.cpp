@@ -1,5 +1,4 @@
 #include "MinimalTriangulator.h"
-#include "DataStructures.h"
 #include <map>
 #include <algorithm>
 #include <iterator>
@@ -11,71 +10,138 @@ MinimalTriangulator::MinimalTriangulator(TriangulationAlgorithm h) : heuristic(h
 // implementing MSC-M algorithm
 ChordalGraph getMinimalTriangulationUsingMSCM(const Graph& g) {
 	// initialize structures
-	ChordalGraph triangulation(g); // holds the result
-	IncreasingWeightNodeQueue queue(g.getNumberOfNodes());
-	vector<bool> handled (g.getNumberOfNodes(), false);
+	int n = g.getNumberOfNodes();
+	// The neighbors of node v are neighbors[neighborOffsets[v]..neighborOffsets[v+1])
+	vector<int> neighborOffsets(n+1, 0);
+	vector<Node> neighbors;
+	neighbors.reserve(2*g.getNumberOfEdges());
+	for (Node v=0; v<n; v++) {
+		const set<Node>& neighborsSet = g.getNeighbors(v);
+		neighbors.insert(neighbors.end(), neighborsSet.begin(), neighborsSet.end());
+		neighborOffsets[v+1] = neighbors.size();
+	}
+	IncreasingWeightNodeQueue queue(n);
+	vector<bool> handled (n, false);
+	// Work areas, reused by every search. A node was reached in the current
+	// search <==> it is stamped with the current iteration.
+	vector<int> reachedStamp(n, -1);
+	vector<NodeSet> reachedByMaxWeight(n, vector<Node>());
+	NodeSet nodesToUpdate;
+	// The fill edges, as consecutive pairs of nodes. They are added to the
+	// triangulation at the end, as the search only reads g.
+	vector<Node> fillEdges;
 	// start search
-	while (!queue.isEmpty()) {
+	for (int iteration=0; !queue.isEmpty(); iteration++) {
 		// Pop node from queue
 		Node v = queue.pop();
 		handled[v] = true;
 		// Find nodes to update
-		NodeSet nodesToUpdate;
-		vector<bool> reached(g.getNumberOfNodes(), false);
-		vector<NodeSet> reachedByMaxWeight(g.getNumberOfNodes(), vector<Node>());
-		for (set<Node>::iterator i=g.getNeighbors(v).begin(); i!=g.getNeighbors(v).end(); ++i) {
-			Node u = *i;
+		nodesToUpdate.clear();
+		int highestWeightReached = -1;
+		for (int i=neighborOffsets[v]; i<neighborOffsets[v+1]; i++) {
+			Node u = neighbors[i];
 			if (!handled[u]) {
 				nodesToUpdate.push_back(u);
-				reached[u] = true;
+				reachedStamp[u] = iteration;
 				reachedByMaxWeight[queue.getWeight(u)].push_back(u);
+				highestWeightReached = max(highestWeightReached, queue.getWeight(u));
 			}
 		}
-		for (int maxWeight=0; maxWeight<g.getNumberOfNodes(); maxWeight++) {
+		for (int maxWeight=0; maxWeight<=highestWeightReached; maxWeight++) {
 			while (!reachedByMaxWeight[maxWeight].empty()) {
 				Node w = reachedByMaxWeight[maxWeight].back();
 				reachedByMaxWeight[maxWeight].pop_back();
-				for (set<Node>::iterator i=g.getNeighbors(w).begin(); i!=g.getNeighbors(w).end(); ++i) {
-					Node u = *i;
-					if (!handled[u] && !reached[u]) {
+				for (int i=neighborOffsets[w]; i<neighborOffsets[w+1]; i++) {
+					Node u = neighbors[i];
+					if (!handled[u] && reachedStamp[u] != iteration) {
 						if (queue.getWeight(u) > maxWeight) {
 							nodesToUpdate.push_back(u);
+							fillEdges.push_back(u);
+							fillEdges.push_back(v);
 						}
-						reached[u] = true;
-						reachedByMaxWeight[max(queue.getWeight(u), maxWeight)].push_back(u);
+						reachedStamp[u] = iteration;
+						int pathWeight = max(queue.getWeight(u), maxWeight);
+						reachedByMaxWeight[pathWeight].push_back(u);
+						highestWeightReached = max(highestWeightReached, pathWeight);
 					}
 				}
 			}
 		}
 		// Update nodes
 		for (NodeSet::iterator j=nodesToUpdate.begin(); j!=nodesToUpdate.end(); ++j) {
-			Node u = *j;
-			queue.increaseWeight(u);
-			triangulation.addEdge(u, v);
+			queue.increaseWeight(*j);
 		}
 	}
+	ChordalGraph triangulation(g); // holds the result
+	for (unsigned int i=0; i<fillEdges.size(); i+=2) {
+		triangulation.addEdge(fillEdges[i], fillEdges[i+1]);
+	}
 	return triangulation;
 }
 
 
-int getFill(const Graph& g, Node v) {
-	const set<Node>& neighborsSet = g.getNeighbors(v);
-	int twiceFillEdges = 0;
-	// for every node in the neighborhood, add the number of non-neighbors
-	for (set<Node>::iterator it=neighborsSet.begin(); it!=neighborsSet.end(); ++it) {
-		vector<bool> notNeighborsOfCurrentNode = g.getNeighborsMap(v);
-		notNeighborsOfCurrentNode[*it] = false;
-		const set<Node>& neighborsOfCurrentNode = g.getNeighbors(*it);
-		for (set<Node>::iterator jt=neighborsOfCurrentNode.begin(); jt!=neighborsOfCurrentNode.end(); ++jt) {
-			notNeighborsOfCurrentNode[*jt] = false;
+FillTracker::FillTracker(const Graph& g) : wordsPerRow(BITWORDS_FOR(g.getNumberOfNodes())),
+		rows(g.getNumberOfNodes()*wordsPerRow, 0), degree(g.getNumberOfNodes(), 0),
+		fill(g.getNumberOfNodes(), 0) {
+	int n = g.getNumberOfNodes();
+	for (Node v=0; v<n; v++) {
+		const set<Node>& neighbors = g.getNeighbors(v);
+		for (set<Node>::const_iterator it=neighbors.begin(); it!=neighbors.end(); ++it) {
+			row(v)[BITWORD_INDEX(*it)] |= BITWORD_MASK(*it);
+		}
+		degree[v] = neighbors.size();
+	}
+	// Every edge inside N(v) is counted twice, once from each endpoint
+	for (Node v=0; v<n; v++) {
+		int twiceEdges = 0;
+		const set<Node>& neighbors = g.getNeighbors(v);
+		for (set<Node>::const_iterator it=neighbors.begin(); it!=neighbors.end(); ++it) {
+			twiceEdges += countCommonNeighbors(v, *it);
 		}
-		for (int i=0; i<g.getNumberOfNodes(); i++) {
-			if (notNeighborsOfCurrentNode[i]) {
-				twiceFillEdges++;
+		fill[v] = (degree[v]*(degree[v]-1) - twiceEdges) / 2;
+	}
+}
+
+int FillTracker::countCommonNeighbors(Node u, Node v) const {
+	int count = 0;
+	for (int i=0; i<wordsPerRow; i++) {
+		count += bitword_count(row(u)[i] & row(v)[i]);
+	}
+	return count;
+}
+
+void FillTracker::addEdge(Node u, Node v) {
+	if (u == v || (row(u)[BITWORD_INDEX(v)] & BITWORD_MASK(v))) {
+		return;
+	}
+	int common = 0;
+	for (int i=0; i<wordsPerRow; i++) {
+		BitWord commonWord = row(u)[i] & row(v)[i];
+		common += bitword_count(commonWord);
+		// u and v are no longer a missing pair in N(w)
+		while (commonWord) {
+			fill[i*BITWORD_BITS + bitword_lowest(commonWord)]--;
+			commonWord &= commonWord - 1;
+		}
+	}
+	// The neighbors of u that are not adjacent to v now miss an edge
+	// to v in N(u), and vice versa
+	fill[u] += degree[u] - common;
+	fill[v] += degree[v] - common;
+	row(u)[BITWORD_INDEX(v)] |= BITWORD_MASK(v);
+	row(v)[BITWORD_INDEX(u)] |= BITWORD_MASK(u);
+	degree[u]++;
+	degree[v]++;
+}
+
+void FillTracker::saturateNodeSets(const set<NodeSet>& s) {
+	for (set<NodeSet>::const_iterator it=s.begin(); it!=s.end(); ++it) {
+		for (NodeSet::const_iterator u=it->begin(); u!=it->end(); ++u) {
+			for (NodeSet::const_iterator v=u+1; v!=it->end(); ++v) {
+				addEdge(*u, *v);
 			}
 		}
 	}
-	return twiceFillEdges/2;
 }
 
 // Returns the minimal separators included in the neighborhood of v
@@ -100,42 +166,57 @@ void makeNodeLBSimplicial(const Graph& g, Graph& gi, Node v) {
 }
 
 class NodeQueue {
-	set< pair<int,Node> > queue;
+	IndexedNodeHeap queue;
 	const Graph& graph;
 	TriangulationAlgorithm heuristic;
+	// Follows the fill of the graph (only for the fill heuristics)
+	unique_ptr<FillTracker> fillTracker;
+	bool usesFill() {
+		return heuristic == MIN_FILL_LB_TRIANG || heuristic == INITIAL_FILL_LB_TRIANG || heuristic == COMBINED;
+	}
 	int score(Node v) {
 		if (heuristic == MIN_DEGREE_LB_TRIANG || heuristic == INITIAL_DEGREE_LB_TRIANG) {
 			return graph.getNeighbors(v).size();
-		} else if (heuristic == MIN_FILL_LB_TRIANG || heuristic == INITIAL_FILL_LB_TRIANG || heuristic == COMBINED) {
-			return getFill(graph, v);
+		} else if (usesFill()) {
+			return fillTracker->getFill(v);
 		}
 		return 0;
 	}
 public:
-	NodeQueue(const Graph& g, TriangulationAlgorithm h) : graph(g), heuristic(h) {
+	NodeQueue(const Graph& g, TriangulationAlgorithm h) : queue(g.getNumberOfNodes()),
+			graph(g), heuristic(h) {
+		if (usesFill()) {
+			fillTracker.reset(new FillTracker(g));
+		}
 		for (Node v=0; v<g.getNumberOfNodes(); v++) {
-			queue.insert(make_pair(score(v), v));
+			queue.push(v, score(v));
+		}
+		// The initial scores are all that's needed
+		if (heuristic == INITIAL_FILL_LB_TRIANG) {
+			fillTracker.reset();
+		}
+	}
+	// Must be called after the given node sets were saturated in the graph
+	void nodeSetsSaturated(const set<NodeSet>& s) {
+		if (fillTracker) {
+			fillTracker->saturateNodeSets(s);
 		}
 	}
 	Node pop() {
-		Node top = queue.begin()->second;
+		Node top = queue.top();
 		// check if score was updates in relevant heuristics
 		if (heuristic == MIN_DEGREE_LB_TRIANG || heuristic == MIN_FILL_LB_TRIANG || heuristic == COMBINED) {
-			int savedScore = queue.begin()->first;
 			int currentScore = score(top);
-			while (currentScore > savedScore) {
-				queue.erase(queue.begin());
-				queue.insert(make_pair(currentScore,top));
-				top = queue.begin()->second;
-				savedScore = queue.begin()->first;
+			while (currentScore > queue.getKey(top)) {
+				queue.update(top, currentScore);
+				top = queue.top();
 				currentScore = score(top);
 			}
 		}
-		queue.erase(queue.begin());
-		return top;
+		return queue.pop();
 	}
 	bool isEmpty() {
-		return queue.empty();
+		return queue.isEmpty();
 	}
 };
 
@@ -149,7 +230,9 @@ ChordalGraph getMinimalTriangulationUsingLBTriang(const Graph& g, TriangulationA
 	} else {
 		NodeQueue queue(result, heuristic);
 		while (!queue.isEmpty()) {
-			makeNodeLBSimplicial(g, result, queue.pop());
+			set<NodeSet> substars = getSubstars(g, result, queue.pop());
+			result.saturateNodeSets(substars);
+			queue.nodeSetsSaturated(substars);
 		}
 	}
 	return result;
@@ -157,7 +240,10 @@ ChordalGraph getMinimalTriangulationUsingLBTriang(const Graph& g, TriangulationA
 
 
 ChordalGraph MinimalTriangulator::triangulate(const Graph& g) {
-	time++;
+	// Only the combined heuristic alternates between the calls
+	if (heuristic == COMBINED) {
+		time++;
+	}
 	if (heuristic == MCS_M || (heuristic == COMBINED && time % 2 == 0)) {
 		return getMinimalTriangulationUsingMSCM(g);
 	}
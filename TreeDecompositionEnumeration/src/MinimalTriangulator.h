@@ -2,12 +2,38 @@
 #define MINIMALTRIANGULATOR_H_
 
 #include "ChordalGraph.h"
+#include "DataStructures.h"
 
 namespace tdenum {
 
 enum TriangulationAlgorithm { MCS_M, MIN_FILL_LB_TRIANG, INITIAL_FILL_LB_TRIANG,
 		MIN_DEGREE_LB_TRIANG, INITIAL_DEGREE_LB_TRIANG, LB_TRIANG, COMBINED, SEPARATORS };
 
+/*
+ * The fill of every node (the number of pairs of its neighbors that are not
+ * adjacent) in a graph that only gains edges. The neighborhoods are kept as
+ * bit rows, so the fill is updated by intersecting the rows of the endpoints
+ * of every new edge.
+ * Used by the fill heuristics of LB-Triang.
+ */
+class FillTracker {
+	int wordsPerRow;
+	vector<BitWord> rows;
+	vector<int> degree;
+	vector<int> fill;
+	BitWord* row(Node v) { return &rows[v*wordsPerRow]; }
+	const BitWord* row(Node v) const { return &rows[v*wordsPerRow]; }
+	int countCommonNeighbors(Node u, Node v) const;
+public:
+	FillTracker(const Graph& g);
+	int getFill(Node v) const { return fill[v]; }
+	// Adds the edge, and updates the fill of its endpoints and of their
+	// common neighbors
+	void addEdge(Node u, Node v);
+	// Adds the edges between the nodes of each set
+	void saturateNodeSets(const set<NodeSet>& s);
+};
+
 /**
  * Calculates a minimal triangulation of the graph
  * Implements MSC-M or LB-Triang with min-fill or min-dgree heuristics
@@ -18,6 +44,8 @@ class MinimalTriangulator {
 public:
 	MinimalTriangulator(TriangulationAlgorithm h);
 	ChordalGraph triangulate(const Graph& g);
+	// Returns the heuristic used (see triangulate())
+	TriangulationAlgorithm getHeuristic() const { return heuristic; }
 };
 
 } /* namespace tdenum */
@@ -2,94 +2,252 @@
 #include "OptimalMinimalTriangulator.h"
 #include "PMCEnumerator.h"
 #include "StatisticRequest.h"
+#include "SubGraph.h"
 #include <queue>
 
 namespace tdenum {
 
-	OptimalMinimalTriangulator::OptimalMinimalTriangulator(const Graph& triangG) :
-		g(triangG), allBlockInfos() {
+// Number of blocks / separators per chunk when building the blocks in parallel
+#define OMT_BLOCK_GRAIN (4)
 
-		// Calculate PMCs
+	OptimalMinimalTriangulator::OptimalMinimalTriangulator(const Graph& triangG,
+			const CancellationToken& token, bool allowParallel) :
+		g(triangG), blocks(), cancelled(false),
+		allow_parallel(allowParallel) {
+
+		// Calculate PMCs. Each one is stored once, and its id is handed to the
+		// blocks including it as soon as it's found.
 		PMCEnumerator pmcEnum(g);
 		pmcEnum.set_algorithm(PMCALG_ENUM_DESCENDING_REVERSE_MS);
+		pmcEnum.set_cancellation_token(token);
 		/*StatisticRequest sr;
 		sr.set_single_pmc_alg(PMCALG_ENUM_DESCENDING_REVERSE_MS)
 		  .set_pmc()
 		  .set_ms();*/
-		pmcs = pmcEnum.get(/*sr*/);
 		minSeps = pmcEnum.get_ms();
-		calculateBlockInfos();
+		calculateBlockInfos(pmcEnum);
+		cancelled = pmcEnum.is_cancelled();
 	}
 
-	void OptimalMinimalTriangulator::calculateBlockInfos() {
-		// Add all graph blocks to allBlockInfos
-		SepToBlockMap sepsToBlocks = calculateSepBlockInfos();
+	void OptimalMinimalTriangulator::calculateBlockInfos(PMCEnumerator& pmcEnum) {
+		// Find all graph blocks, with the main blocks last
+		BlockVec found;
+		SepToBlockMap sepsToBlocks;
+		calculateSepBlocks(found, sepsToBlocks);
+		int numSepBlocks = found.size();
+		calculateMainBlocks(found);
+		numMainBlocks = found.size() - numSepBlocks;
+
+		vector<vector<int> > blockPMCs(found.size());
+		addPMCs(pmcEnum, found, sepsToBlocks, numSepBlocks, blockPMCs);
 
-		// sort blocks by size
-		sort(allBlockInfos.begin(), allBlockInfos.end(),
-			[](BlockInfo* b1, BlockInfo* b2) {
-			return (b1->blockSize() < b2->blockSize());
+		// sort blocks by size (blocks of equal size keep the order they were
+		// found in), and keep the main component blocks at the end
+		vector<int> order(numSepBlocks);
+		for (int i = 0; i < numSepBlocks; i++)
+			order[i] = i;
+		stable_sort(order.begin(), order.end(), [&](int b1, int b2) {
+			return (found[b1]->nodes.size() < found[b2]->nodes.size());
 		});
+		for (unsigned int i = numSepBlocks; i < found.size(); i++)
+			order.push_back(i);
 
-		// Add main component blocks at end of allBlockInfos
-		calculateMainBlockInfos();
-
-		// update block locations
-		for (unsigned int i = 0; i < allBlockInfos.size(); i++)
-			allBlockInfos[i]->updateLocation(i, sepsToBlocks);
+		// Lay out the blocks and their PMCs in that order. The PMCs of each
+		// block are kept in ascending order.
+		const NodeSetSet& pmcs = blocks.pmcs;
+		blocks.blocks.reserve(order.size());
+		blocks.pmcOffsets.reserve(order.size() + 1);
+		blocks.pmcOffsets.push_back(0);
+		for (unsigned int i = 0; i < order.size(); i++) {
+			blocks.blocks.push_back(*found[order[i]]);
+			vector<int>& ids = blockPMCs[order[i]];
+			sort(ids.begin(), ids.end(), [&](int p1, int p2) {
+				return *(pmcs.begin() + p1) < *(pmcs.begin() + p2);
+			});
+			blocks.pmcIDs.insert(blocks.pmcIDs.end(), ids.begin(), ids.end());
+			blocks.pmcOffsets.push_back(blocks.pmcIDs.size());
+			vector<int>().swap(ids);
+		}
+		calculateSubBlocks();
 	}
 
-	SepToBlockMap OptimalMinimalTriangulator::calculateSepBlockInfos() {
-		SepToBlockMap sepsToBlocks;
-		for (auto sep = minSeps.begin(); sep != minSeps.end(); sep++) {
-			// Find all PMCs which sep is a subset of
-			NodeSetSet pmcsContainingSep;
-			for (auto pmc = pmcs.begin(); pmc != pmcs.end(); pmc++) {
-				if (includes(pmc->begin(), pmc->end(),
-					sep->begin(), sep->end()))
-					pmcsContainingSep.insert(*pmc);
-			}
+	void OptimalMinimalTriangulator::calculateSepBlocks(BlockVec& found,
+			SepToBlockMap& sepsToBlocks) {
+		// The blocks of each separator are built in parallel, and then
+		// collected in the order of the separators.
+		vector<const MinimalSeparator*> seps;
+		for (auto sep = minSeps.begin(); sep != minSeps.end(); sep++)
+			seps.push_back(&*sep);
+		vector<BlockVec> sepBlocks(seps.size());
+		#pragma omp parallel for if(allow_parallel) schedule(dynamic, OMT_BLOCK_GRAIN)
+		for (long i = 0; i < (long)seps.size(); i++) {
 			// Find all full blocks of sep
-			BlockVec sepBlocks = g.getBlocks(*sep);
-			sepsToBlocks[*sep] = vector<BlockInfo*>();
-			for (auto b = sepBlocks.begin(); b != sepBlocks.end(); b++)
+			BlockVec blocksOfSep = g.getBlocks(*seps[i]);
+			for (auto b = blocksOfSep.begin(); b != blocksOfSep.end(); b++)
 				// Save only full blocks
-				if ((*b)->S.size() == sep->size()) {
-					BlockInfo* bInfo = new BlockInfo(g, *b);
-					bInfo->updatePMCs(pmcsContainingSep);
-					allBlockInfos.push_back(bInfo);
-					sepsToBlocks[*sep].push_back(bInfo);
-				}
+				if ((*b)->S.size() == seps[i]->size())
+					sepBlocks[i].push_back(*b);
 		}
-		return sepsToBlocks;
+
+		for (unsigned int i = 0; i < seps.size(); i++) {
+			vector<int>& locs = sepsToBlocks[*seps[i]];
+			for (auto b = sepBlocks[i].begin(); b != sepBlocks[i].end(); b++) {
+				locs.push_back(found.size());
+				found.push_back(*b);
+			}
+		}
+	}
+
+	void OptimalMinimalTriangulator::addPMCs(PMCEnumerator& pmcEnum,
+			const BlockVec& found, const SepToBlockMap& sepsToBlocks,
+			int firstMainBlock, vector<vector<int> >& blockPMCs) {
+		// Keep the separators that have full blocks as rows of W bit words,
+		// indexed by their first node. A separator can only be contained in
+		// PMCs including its first node, and for those containment takes a
+		// single pass over the W words.
+		int n = g.getNumberOfNodes();
+		int W = (n + BITWORD_BITS - 1) / BITWORD_BITS;
+		vector<BitWord> sepRows;
+		vector<const vector<int>*> sepBlocks;
+		vector<vector<int> > sepsByFirstNode(n);
+		for (auto sep = sepsToBlocks.cbegin(); sep != sepsToBlocks.cend(); sep++) {
+			if (sep->first.empty() || sep->second.empty())
+				continue;
+			int id = sepBlocks.size();
+			sepBlocks.push_back(&sep->second);
+			sepRows.resize((id+1)*W, 0);
+			for (auto v = sep->first.begin(); v != sep->first.end(); v++)
+				sepRows[id*W + BITWORD_INDEX(*v)] |= BITWORD_MASK(*v);
+			sepsByFirstNode[sep->first[0]].push_back(id);
+		}
+
+		NodeSetSet& pmcs = blocks.pmcs;
+		vector<BitWord> pmcRow(W, 0);
+		pmcEnum.visit([&](const NodeSet& pmc) {
+			int pmcID = pmcs.size();
+			pmcs.insert(pmc);
+			for (auto v = pmc.begin(); v != pmc.end(); v++)
+				pmcRow[BITWORD_INDEX(*v)] |= BITWORD_MASK(*v);
+			for (auto v = pmc.begin(); v != pmc.end(); v++)
+				for (int id : sepsByFirstNode[*v]) {
+					const BitWord* S = &sepRows[id*W];
+					int w = 0;
+					while (w < W && !(S[w] & ~pmcRow[w]))
+						w++;
+					if (w == W)
+						for (int loc : *sepBlocks[id])
+							if (found[loc]->includesNodes(pmc))
+								blockPMCs[loc].push_back(pmcID);
+				}
+			for (auto v = pmc.begin(); v != pmc.end(); v++)
+				pmcRow[BITWORD_INDEX(*v)] = 0;
+			for (unsigned int loc = firstMainBlock; loc < found.size(); loc++)
+				if (found[loc]->includesNodes(pmc))
+					blockPMCs[loc].push_back(pmcID);
+		});
 	}
 
-	void OptimalMinimalTriangulator::calculateMainBlockInfos() {
+	void OptimalMinimalTriangulator::calculateMainBlocks(BlockVec& found) {
 		// Add a "block" representing the whole graph so it will be optimized as well
 		MinimalSeparator emptySep;
 		vector<NodeSet> gComps = g.getComponents(emptySep);
 
-		for (auto comp = gComps.begin(); comp != gComps.end(); comp++) {
-			BlockInfo* compBlockInfo = new BlockInfo(g, BlockPtr(new Block(emptySep, *comp, g.getNumberOfNodes())));
-			compBlockInfo->updatePMCs(pmcs);
-			allBlockInfos.push_back(compBlockInfo);
+		for (auto comp = gComps.begin(); comp != gComps.end(); comp++)
+			found.push_back(BlockPtr(new Block(emptySep, *comp)));
+	}
+
+	void OptimalMinimalTriangulator::calculateSubBlocks() {
+		// Full blocks are identified by their components, so index the
+		// blocks by component once; the sub blocks of each block's PMCs are
+		// then found independently, into a buffer per block.
+		int numBlocks = blocks.size();
+		NodeSetSet blockComponents;
+		for (int i = 0; i < numBlocks; i++)
+			blockComponents.insert(blocks.block(i).C);
+		if ((int)blockComponents.size() != numBlocks)
+			TRACE(TRACE_LVL__ERROR, "Two blocks share a component!");
+
+		int numEntries = blocks.pmcIDs.size();
+		vector<int> subBlockCounts(numEntries, 0);
+		vector<vector<int> > blockSubBlocks(numBlocks);
+		#pragma omp parallel for if(allow_parallel) schedule(dynamic, OMT_BLOCK_GRAIN)
+		for (long i = 0; i < (long)numBlocks; i++) {
+			const Block& B = blocks.block(i);
+			if (blocks.firstEntry(i) == blocks.endEntry(i))
+				continue;
+			// SubGraph of the original graph, induced by block nodes
+			SubGraph GinducedB(g, B.nodes);
+			for (int entry = blocks.firstEntry(i); entry < blocks.endEntry(i); entry++) {
+				// Each block of the PMC is a full block, so its component
+				// identifies it (S is the neighborhood of C).
+				BlockVec pmcBlocks = GinducedB.getBlocksByMain(blocks.pmc(entry));
+				for (auto pmcBlock = pmcBlocks.begin(); pmcBlock != pmcBlocks.end(); pmcBlock++) {
+					auto it = blockComponents.find((*pmcBlock)->C);
+					if (it == blockComponents.end())
+						continue;
+					int loc = it - blockComponents.begin();
+					if (blocks.block(loc).S == (*pmcBlock)->S) {
+						blockSubBlocks[i].push_back(loc);
+						subBlockCounts[entry]++;
+					}
+				}
+			}
 		}
 
-		numMainBlocks = gComps.size();
+		// The entries of each block are consecutive, so the buffers are
+		// concatenated in block order
+		blocks.subBlockOffsets.resize(numEntries + 1);
+		blocks.subBlockOffsets[0] = 0;
+		for (int entry = 0; entry < numEntries; entry++)
+			blocks.subBlockOffsets[entry+1] = blocks.subBlockOffsets[entry] + subBlockCounts[entry];
+		blocks.subBlockIDs.reserve(blocks.subBlockOffsets[numEntries]);
+		for (int i = 0; i < numBlocks; i++) {
+			blocks.subBlockIDs.insert(blocks.subBlockIDs.end(),
+				blockSubBlocks[i].begin(), blockSubBlocks[i].end());
+			vector<int>().swap(blockSubBlocks[i]);
+		}
 	}
 
-	TriangulationResult OptimalMinimalTriangulator::triangulate(TriangulationEvaluator* eval) {
+	void OptimalMinimalTriangulator::evaluateBlocks(TriangulationEvaluator* eval,
+			vector<const NodeSet*>& bestBlockPMCs) const {
 		// Calculate Omega(S,C) for each block
-		vector<const NodeSet*> bestBlockPMCs;
-		for (auto bInfo = allBlockInfos.begin(); bInfo != allBlockInfos.end(); bInfo++) {
-			eval->startNewBlock((*bInfo)->B);
-			for (auto pmcToB = (*bInfo)->pmcToBlocks.begin();
-				pmcToB != (*bInfo)->pmcToBlocks.end(); pmcToB++)
-				eval->evalSaturatePMC(pmcToB->first, pmcToB->second);
-			bestBlockPMCs.push_back(eval->getBestPMC());
+		int numBlocks = blocks.size();
+		bestBlockPMCs.resize(numBlocks);
+		for (int i = 0; i < numBlocks; i++) {
+			// An extended evaluator only recalculates the blocks affected by
+			// its new constraints
+			if (!eval->needsBlockUpdate(blocks.block(i))) {
+				eval->keepBlock(blocks.block(i));
+				bestBlockPMCs[i] = eval->getBestPMC();
+				continue;
+			}
+			eval->startNewBlock(blocks.block(i));
+			for (int entry = blocks.firstEntry(i); entry < blocks.endEntry(i); entry++)
+				eval->evalSaturatePMC(blocks.pmc(entry), blocks.subBlocks(entry));
+			bestBlockPMCs[i] = eval->getBestPMC();
 		}
 		// Make sure eval saves the last block
 		eval->finishedCurBlock();
+	}
+
+	float OptimalMinimalTriangulator::evaluate(TriangulationEvaluator* eval) const {
+		if (cancelled)
+			return CONSTRAINT_VIOLATION;
+		vector<const NodeSet*> bestBlockPMCs;
+		evaluateBlocks(eval, bestBlockPMCs);
+		return eval->getOptimalCost(numMainBlocks);
+	}
+
+	TriangulationResult OptimalMinimalTriangulator::triangulate(TriangulationEvaluator* eval) const {
+		if (cancelled) {
+			TriangulationResult res;
+			res.cost = CONSTRAINT_VIOLATION;
+			res.eval = eval;
+			return res;
+		}
+		int numBlocks = blocks.size();
+		vector<const NodeSet*> bestBlockPMCs;
+		evaluateBlocks(eval, bestBlockPMCs);
 
 		// Build a chordal graph by filling in the optimal PMCs
 		ChordalGraph triang(g);
@@ -98,7 +256,7 @@ namespace tdenum {
 
 		//Start with PMC of last blocks - the ones representing connected components of the graph
 		for (int i = 1; i <= numMainBlocks; i++)
-			bestBlockIDs.push(allBlockInfos.size() - i);
+			bestBlockIDs.push(numBlocks - i);
 
 		while (bestBlockIDs.size() > 0) {
 			// Pop the next chosen block for processing
@@ -108,13 +266,14 @@ namespace tdenum {
 			const NodeSet& curBlockPMC = *bestBlockPMCs[curBlockID];
 			triang.addClique(curBlockPMC);
 
-			BlockInfo* curBlock = allBlockInfos[curBlockID];
-			if (curBlock->B.S.size() > 0)
-				triangSeps.insert(curBlock->B.S);
+			const Block& curBlock = blocks.block(curBlockID);
+			if (curBlock.S.size() > 0)
+				triangSeps.insert(curBlock.S);
 
 			// Add this PMCs blocks to be processed
-			for (auto subBlock = curBlock->pmcToBlocks[curBlockPMC].begin();
-				subBlock != curBlock->pmcToBlocks[curBlockPMC].end(); subBlock++)
+			int entry = blocks.findEntry(curBlockID, &curBlockPMC);
+			BlockIDRange subBlocks = blocks.subBlocks(entry);
+			for (auto subBlock = subBlocks.begin(); subBlock != subBlocks.end(); subBlock++)
 				bestBlockIDs.push(*subBlock);
 		}
 
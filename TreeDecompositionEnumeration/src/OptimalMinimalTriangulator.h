@@ -6,8 +6,11 @@
 #include "DataStructures.h"
 #include "BlockInfo.h"
 #include "TriangulationEvaluator.h"
+#include "Utils.h"
 
 namespace tdenum {
+	class PMCEnumerator;
+
 	struct TriangulationResult {
 		ChordalGraph triangulation;
 		NodeSetSet minSeps;
@@ -26,22 +29,54 @@ namespace tdenum {
 		const Graph& g;
 		//NodeSetSet minSeps;
 		//NodeSetSet pmcs;
-		vector<BlockInfo*> allBlockInfos;
+		// The full blocks sorted by size, followed by the main blocks (the
+		// components of the graph), and their PMCs
+		BlockTable blocks;
 		int numMainBlocks;
+		// Set if the PMC enumeration was cancelled
+		bool cancelled;
+		// If true, the blocks are built by several threads
+		bool allow_parallel;
 
-		void calculateBlockInfos();
-		SepToBlockMap calculateSepBlockInfos();
-		void calculateMainBlockInfos();
+		void calculateBlockInfos(PMCEnumerator& pmcEnum);
+		// Appends the full blocks of the separators to found, and maps each
+		// separator to the locations of its blocks in found
+		void calculateSepBlocks(BlockVec& found, SepToBlockMap& sepsToBlocks);
+		void calculateMainBlocks(BlockVec& found);
+		// Adds the id of each PMC to the blocks including it, as the
+		// enumerator finds it. The blocks from firstMainBlock on get every PMC.
+		void addPMCs(PMCEnumerator& pmcEnum, const BlockVec& found,
+			const SepToBlockMap& sepsToBlocks, int firstMainBlock,
+			vector<vector<int> >& blockPMCs);
+		// Fills the sub block locations of each entry of the table
+		void calculateSubBlocks();
+		// Runs the evaluator over the blocks, and sets the best PMC of each
+		void evaluateBlocks(TriangulationEvaluator* eval,
+			vector<const NodeSet*>& bestBlockPMCs) const;
 	public:
 
 		NodeSetSet minSeps;
-		NodeSetSet pmcs;
 
-		OptimalMinimalTriangulator(const Graph& g);
+		// Cancelling the token stops the PMC enumeration. The blocks then
+		// hold only the PMCs found so far (see isCancelled()).
+		// With allowParallel, the blocks of the separators are found, and the
+		// sub blocks of their PMCs resolved, in parallel. The blocks are the
+		// same either way.
+		OptimalMinimalTriangulator(const Graph& g,
+			const CancellationToken& token = CancellationToken(),
+			bool allowParallel = false);
 		
-		int getNumBlocks() { return allBlockInfos.size(); }
+		int getNumBlocks() const { return blocks.size(); }
+
+		// If true, not all PMCs were found, and triangulate() returns a result
+		// with cost CONSTRAINT_VIOLATION.
+		bool isCancelled() const { return cancelled; }
 
-		TriangulationResult triangulate(TriangulationEvaluator*);
+		// Only reads the triangulator, so different evaluators may be used
+		// concurrently.
+		TriangulationResult triangulate(TriangulationEvaluator*) const;
+		// Returns the cost of the optimal triangulation, without building it
+		float evaluate(TriangulationEvaluator*) const;
 	};
 
 } /* namespace tdenum */
@@ -3,6 +3,7 @@
 #include "Utils.h"
 #include <set>
 #include <algorithm>
+#include <memory>
 
 namespace tdenum {
 
@@ -11,55 +12,57 @@ int PMCE_RUNMODE = PMCE_RUNMODE_FAST;
 /**
  * A macro used to stop everything and return if the time
  * limit is reached.
+ * Reads the clock only once in a while (see Deadline), so it may be used in
+ * inner loops. CHECK_TIME_NOW_OR_OP always reads it.
  *
  * Parallelized code can't do that, so use workarounds..
  */
-#define CHECK_TIME_OR_OP(_op) do { \
-        if (limit != 0 && difftime(time(NULL),start_time) >= limit) { \
+#define CHECK_DEADLINE_OR_OP(_expired, _op) do { \
+        if (_expired) { \
             out_of_time = true; \
             TRACE(TRACE_LVL__DEBUG, "Out of time!"); \
             _op; \
         } \
     } while(0)
+#define CHECK_TIME_OR_OP(_op) CHECK_DEADLINE_OR_OP(deadline.expired(), _op)
+#define CHECK_TIME_NOW_OR_OP(_op) CHECK_DEADLINE_OR_OP(deadline.expired_now(), _op)
 
 /**
  * Verify the given container is sorted (check the runmode first).
- * Should be used in the parallel context of one_more_vertex or
- * is_pmc, respectively.
+ * Should be used in the parallel context of one_more_vertex.
  */
 #define VERIFY_SORT_OMV(_cont) do { \
         if (PMCE_RUNMODE == PMCE_RUNMODE_VERIFY_SORT) { \
             if (!std::is_sorted((_cont).begin(), (_cont).end())) { \
                 TRACE(TRACE_LVL__ERROR, "Unsorted NodeSet " #_cont ": " << (_cont) << ". Returning an empty set"); \
                 keep_running = false; \
-                P1 = NodeSetSet(); \
+                sorted_input = false; \
                 continue; \
             } \
         } \
     } while(0)
 
-#define VERIFY_SORT_ISPMC(_cont) do { \
-        if (PMCE_RUNMODE == PMCE_RUNMODE_VERIFY_SORT) { \
-            if (!std::is_sorted((_cont).begin(), (_cont).end())) { \
-                TRACE(TRACE_LVL__ERROR, "Unsorted NodeSet " #_cont ": " << (_cont) << ". Returning FALSE"); \
-                return false; \
-            } \
-        } \
-    } while(0)
+/**
+ * Number of candidate separators per chunk in the parallel reverse-MS
+ * precalculation.
+ */
+#define PMCE_MS_GRAIN (32)
 
 
 const PMCAlg PMCEnumerator::default_alg = PMCAlg();
 
-PMCEnumerator::PMCEnumerator(const Graph& g, time_t time_limit) :
+PMCEnumerator::PMCEnumerator(const Graph& g, double time_limit) :
         graph(g),
         alg(default_alg),
         has_ms(false),
         ms_subgraph_count(g.getNumberOfNodes()),
+        store_ms_subgraphs(true),
         allow_parallel(false),
         done(false),
         limit(time_limit),
-        start_time(time(NULL)),
-        out_of_time(false)
+        deadline(time_limit),
+        out_of_time(false),
+        visitor(NULL)
 {
     omp_init_lock(&lock);
     ms.clear();
@@ -71,16 +74,23 @@ PMCEnumerator::~PMCEnumerator() {
     omp_destroy_lock(&lock);
 }
 
-PMCEnumerator& PMCEnumerator::reset(const Graph& g, time_t time_limit) { return (*this = PMCEnumerator(g, time_limit)); }
+PMCEnumerator& PMCEnumerator::reset(const Graph& g, double time_limit) { return (*this = PMCEnumerator(g, time_limit)); }
 
 PMCEnumerator& PMCEnumerator::set_algorithm(PMCAlg a) { alg = a; return *this; }
 PMCAlg PMCEnumerator::get_alg() const { return alg; }
 
-PMCEnumerator& PMCEnumerator::set_time_limit(time_t t) { limit = t; return *this; }
-PMCEnumerator& PMCEnumerator::unset_time_limit() { limit = 0; return *this; }
+PMCEnumerator& PMCEnumerator::set_time_limit(double t) { limit = t; deadline.set_limit(t); return *this; }
+PMCEnumerator& PMCEnumerator::unset_time_limit() { return set_time_limit(0); }
 
 PMCEnumerator& PMCEnumerator::enable_parallel() { allow_parallel = true; return *this; }
 PMCEnumerator& PMCEnumerator::suppress_parallel() { allow_parallel = false; return *this; }
+PMCEnumerator& PMCEnumerator::enable_ms_subgraphs() { store_ms_subgraphs = true; return *this; }
+PMCEnumerator& PMCEnumerator::suppress_ms_subgraphs() { store_ms_subgraphs = false; return *this; }
+PMCEnumerator& PMCEnumerator::set_cancellation_token(const CancellationToken& token) {
+    cancel_token = token;
+    deadline.watch(token);
+    return *this;
+}
 
 /**
  * Allows caller to report the minimal separators of the graph.
@@ -109,8 +119,14 @@ NodeSetSet PMCEnumerator::get_ms() {
             return ms;
         }
         MinimalSeparatorsEnumerator mse(graph, UNIFORM);
-        if (!mse.getAll(ms, difftime(limit,difftime(time(NULL),start_time)))) {
+        if (allow_parallel) {
+            mse.enable_parallel();
+        }
+        if (!mse.getAll(ms, deadline)) {
+            // Some separators may be missing, so calculate them again next
+            // time
             out_of_time = true;
+            return ms;
         }
         ms_subgraph_count[graph.getNumberOfNodes()-1] = ms.size();
         has_ms = true;
@@ -153,7 +169,7 @@ NodeSetSet PMCEnumerator::get(/*const StatisticRequest& sr*/) {
     if (!done) {
 
         // Cleanup
-        start_time = time(NULL);
+        deadline.reset(limit);
         pmcs.clear();
 
         /**
@@ -165,6 +181,12 @@ NodeSetSet PMCEnumerator::get(/*const StatisticRequest& sr*/) {
         Graph tmp_graph = graph;
         int n = tmp_graph.getNumberOfNodes();
 
+        // The visitor expects the original names
+        PMCVisitor report = [&](const NodeSet& K) {
+            (*visitor)(tmp_graph.getOriginalNames(K));
+        };
+        const PMCVisitor* last_report = visitor ? &report : NULL;
+
         // If the graph is empty..
         if (n <= 0) {
             done = true;
@@ -180,19 +202,11 @@ NodeSetSet PMCEnumerator::get(/*const StatisticRequest& sr*/) {
         }
         vector<Node> nodes = tmp_graph.getNodesVector();
 
-        TRACE(TRACE_LVL__NOISE, "Done renaming. Calculating subgraphs...");
-
-        // Start by creating all subgraphs.
-        // This should not constitute a memory bottleneck... if so,
-        // the graphs are WAY too large for these algorithms :)
-        vector<SubGraph> subg;
-        for (int i=1; i<=n; ++i) {
-            vector<Node> subnodes = nodes;
-            subnodes.resize(i);
-            subg.push_back(SubGraph(tmp_graph, subnodes));
-        }
+        TRACE(TRACE_LVL__NOISE, "Done renaming. Is the algorithm a reverse-MS type?");
 
-        TRACE(TRACE_LVL__NOISE, "Done calculating subgraphs. Is the algorithm a reverse-MS type?");
+        // The subgraphs G_i (induced by the first i+1 nodes) aren't all
+        // kept in memory: each reverse-MS level builds its own, and the main
+        // loop derives G_i from G_{i-1} and keeps only those two.
 
         // Optionally use the (memory-inefficient) algorithm, which
         // calculates the minimal separators in advance:
@@ -204,53 +218,62 @@ NodeSetSet PMCEnumerator::get(/*const StatisticRequest& sr*/) {
 
 
             // Calculate the first set of minimal separators
-            CHECK_TIME_OR_OP(return NodeSetSet());
+            CHECK_TIME_NOW_OR_OP(return NodeSetSet());
 
             // Use the algorithm described in the PDF
             for (int i=n-2; i>=0; --i) {
 
                 TRACE(TRACE_LVL__NOISE, "In reverse MS iteration, i=" << i);
+                CHECK_TIME_NOW_OR_OP(return NodeSetSet());
 
                 sub_ms[i].clear();
+                SubGraph subg(tmp_graph, NodeSet(nodes.begin(), nodes.begin()+i+1));
 
-                // To prevent checking both S and S u {v}, if they exist
-                NodeSetSet checked_seps;
-
-                // For all S in the parent minimal separators:
+                // The separators of G_{i+1} are independent candidates, so
+                // split them between the threads. Each thread keeps its own
+                // checked separators and results, merged after the level.
+                vector<const NodeSet*> parent_seps;
+                parent_seps.reserve(sub_ms[i+1].size());
                 for (auto it=sub_ms[i+1].begin(); it!=sub_ms[i+1].end(); ++it) {
-                    // Get S
-                    NodeSet S = *it;
-
-                    // S <- S\{v}
-                    // Assume S is sorted in ascending order, and that each subgraph
-                    // includes the i smallest nodes.
-                    // Note that S may be the empty set - the same logic applies (the
-                    // empty has two full components <==> the graph isn't connected, and
-                    // then S is indeed a minimal separator).
-                    if (!S.empty() && S[S.size()-1] == nodes[i+1]) {
-                        S.pop_back();
-                    }
-                    // Make sure it hasn't been checked before
-                    if (checked_seps.isMember(S)) {
-                        continue;
-                    }
-                    // Get connected components of subg[i](S)
-                    auto components = subg[i].getComponents(S);
-                    // Count how many are full components. Stop at 2.
-                    int full_components = 0;
-                    for (auto C: components) {
-                        if (subg[i].isFullComponent(C,S)) {
-                            ++full_components;
-                            if (full_components >= 2) {
-                                break;
-                            }
+                    parent_seps.push_back(&*it);
+                }
+                vector<NodeSetSet> found(allow_parallel ? omp_get_max_threads() : 1);
+
+                #pragma omp parallel if(allow_parallel)
+                {
+                    // To prevent checking both S and S u {v}, if they exist
+                    NodeSetSet checked_seps;
+                    ComponentScan scan;
+
+                    // For all S in the parent minimal separators:
+                    #pragma omp for schedule(dynamic, PMCE_MS_GRAIN)
+                    for (long k=0; k<(long)parent_seps.size(); ++k) {
+                        // Get S
+                        NodeSet S = *parent_seps[k];
+
+                        // S <- S\{v}
+                        // Assume S is sorted in ascending order, and that each subgraph
+                        // includes the i smallest nodes.
+                        // Note that S may be the empty set - the same logic applies (the
+                        // empty has two full components <==> the graph isn't connected, and
+                        // then S is indeed a minimal separator).
+                        if (!S.empty() && S[S.size()-1] == nodes[i+1]) {
+                            S.pop_back();
+                        }
+                        // Make sure it hasn't been checked before
+                        if (checked_seps.isMember(S)) {
+                            continue;
+                        }
+                        checked_seps.insert(S);
+                        // Get connected components of G_i\S, and add S
+                        // if there were at least two full components
+                        subg.scanComponents(S, scan);
+                        if (scan.getNumberOfFullComponents() >= 2) {
+                            found[omp_get_thread_num()].insert(S);
                         }
-                    }
-                    // Add S if there were at least two full components
-                    if (full_components >= 2) {
-                        sub_ms[i].insert(S);
                     }
                 }
+                merge_thread_buffers(found, sub_ms[i]);
                 ms_subgraph_count[i] = sub_ms[i].size();
             }
         }
@@ -267,20 +290,26 @@ NodeSetSet PMCEnumerator::get(/*const StatisticRequest& sr*/) {
         // If the nodes of G are {a_1,...,a_n} then P1 = {{a1}}
         pmcs.insert(NodeSet({nodes[0]})); // Later, PMCi=PMCip1
 
+        // G_{i-1} and G_i, respectively
+        std::unique_ptr<SubGraph> prev_subg(new SubGraph(tmp_graph, NodeSet({nodes[0]})));
+        std::unique_ptr<SubGraph> subg;
+
         TRACE(TRACE_LVL__NOISE, "Done with reverse-MS part, starting main loop...");
 
         // MS1 should remain empty, so MSi=MSip1 is OK
         for (int i=1; i<n; ++i) {
 
             TRACE(TRACE_LVL__NOISE, "In PMC iterations after MS iterations, i=" << i);
+            CHECK_TIME_NOW_OR_OP(return NodeSetSet());
 
             // Calculate MSip1 and PMCip1, and use OneMoreVertex.
             // This is the main function described in the paper.
-            prev_pmcs = pmcs;
-            MSi = MSip1;
+            prev_pmcs.swap(pmcs);
+            MSi.swap(MSip1);
             pmcs.clear();
             MSip1.clear();
             Node a = nodes[i];
+            subg.reset(new SubGraph(*prev_subg, a));
 
             // Calculate MSip1 and then the next set of PMCs.
             // If there's no need, just run the next function.
@@ -288,29 +317,40 @@ NodeSetSet PMCEnumerator::get(/*const StatisticRequest& sr*/) {
             // The NORMAL algorithm requires calculation of separators
             if (!alg.is_reverse()) {
                 if (i == n-1) {
-                    TRACE(TRACE_LVL__OFF, "Last iteration, moving from:" << endl << subg[i-1] <<
-                                           "To (by adding node " << a << "):" << endl << subg[i] <<
+                    TRACE(TRACE_LVL__OFF, "Last iteration, moving from:" << endl << *prev_subg <<
+                                           "To (by adding node " << a << "):" << endl << *subg <<
                                            "With minimal separators " << MSi << " and " <<
                                            tmp_graph.getNewNames(get_ms()) << ", respectively.");
-                    pmcs = one_more_vertex(subg[n-1], subg[n-2], a, sub_ms[n-1], MSi, prev_pmcs);
+                    pmcs = one_more_vertex(*subg, *prev_subg, a, sub_ms[n-1], MSi, prev_pmcs, last_report);
                 }
                 else {
-                    MinimalSeparatorsEnumerator DiEnumerator(subg[i], UNIFORM);
-                    DiEnumerator.getAll(MSip1, difftime(limit,difftime(time(NULL),start_time)));
-                    CHECK_TIME_OR_OP(return NodeSetSet());
-                    sub_ms[i] = MSip1;
+                    MinimalSeparatorsEnumerator DiEnumerator(*subg, UNIFORM);
+                    if (allow_parallel) {
+                        DiEnumerator.enable_parallel();
+                    }
+                    DiEnumerator.getAll(MSip1, deadline);
+                    CHECK_TIME_NOW_OR_OP(return NodeSetSet());
+                    if (store_ms_subgraphs) {
+                        sub_ms[i] = MSip1;
+                    }
                     ms_subgraph_count[i] = MSip1.size();
-                    pmcs = one_more_vertex(subg[i], subg[i-1], a, MSip1, MSi, prev_pmcs);
+                    pmcs = one_more_vertex(*subg, *prev_subg, a, MSip1, MSi, prev_pmcs);
                 }
                 TRACE(TRACE_LVL__OFF, "Current pmcs: " << tmp_graph.getOriginalNames(pmcs));
             }
             else {
-                pmcs = one_more_vertex(subg[i], subg[i-1], a, sub_ms[i], sub_ms[i-1], prev_pmcs);
+                pmcs = one_more_vertex(*subg, *prev_subg, a, sub_ms[i], sub_ms[i-1], prev_pmcs,
+                                       i == n-1 ? last_report : NULL);
                 TRACE(TRACE_LVL__OFF, "With i=" << i << ", where the parent graph is:" << endl
-                      << subg[i] << "and the subgraph is:" << endl << subg[i-1]
+                      << *subg << "and the subgraph is:" << endl << *prev_subg
                       << "We have minimal separators " << sub_ms[i] << " and " << sub_ms[i-1]
                       << ", main graph / subgraph respectively. As a result, we got PMCs " << pmcs);
+                // Level i-1 is no longer needed
+                if (!store_ms_subgraphs) {
+                    NodeSetSet().swap(sub_ms[i-1]);
+                }
             }
+            prev_subg = std::move(subg);
         }
 
         // Update the minimal separators
@@ -319,13 +359,21 @@ NodeSetSet PMCEnumerator::get(/*const StatisticRequest& sr*/) {
             ms_subgraph_count[n-1] = ms.size();
             has_ms = true;
         }
-        if (/*sr.test_ms_subgraphs()*/true) {
+        // Without stored levels, ms_subgraph_count was updated along the way.
+        if (store_ms_subgraphs) {
             TRACE(TRACE_LVL__TEST, "Setting MS subgraphs to " << sub_ms);
-            ms_subgraphs = sub_ms;
+            ms_subgraphs.swap(sub_ms);
             update_ms_subgraph_count();
         }
-        /*else */if (true/*sr.test_ms_subgraph_count()*/) {
-            read_ms_subgraph_count_from_vector(sub_ms);
+
+        // With a visitor, the PMCs were already reported (a single node
+        // graph has no iterations, so report it here).
+        if (visitor) {
+            if (n == 1) {
+                report(NodeSet({nodes[0]}));
+            }
+            pmcs.clear();
+            return NodeSetSet();
         }
 
         // That's it! Translate to user-friendly state
@@ -335,24 +383,64 @@ NodeSetSet PMCEnumerator::get(/*const StatisticRequest& sr*/) {
     }
 
     // Update
-    CHECK_TIME_OR_OP(((void)0));
+    CHECK_TIME_NOW_OR_OP(((void)0));
     return pmcs;
 }
 
+bool PMCEnumerator::visit(const PMCVisitor& v) {
+    if (done) {
+        for (auto it = pmcs.begin(); it != pmcs.end(); ++it) {
+            v(*it);
+        }
+        return !out_of_time;
+    }
+    visitor = &v;
+    get();
+    visitor = NULL;
+    return !out_of_time;
+}
+
+bool PMCEnumerator::spill(const string& filename) {
+    NodeSetFileWriter writer(filename);
+    if (!writer.isOpen()) {
+        TRACE(TRACE_LVL__ERROR, "Couldn't open '" << filename << "' for writing");
+        return false;
+    }
+    bool completed = visit([&writer](const NodeSet& K) { writer.write(K); });
+    TRACE(TRACE_LVL__NOISE, "Wrote " << writer.getCount() << " PMCs to '" << filename << "'");
+    return completed;
+}
+
+/**
+ * Task granularity of the parallel loops in one_more_vertex: the number of
+ * PMCs of P2 / separators of D1 per task, and the number of separators of D2
+ * per task when the inner loop over D2 is split.
+ * Chunks keep the scheduling overhead low, while leaving enough tasks for
+ * idle threads to pick up.
+ */
+#define PMCE_P2_GRAIN (16)
+#define PMCE_D1_GRAIN (2)
+#define PMCE_D2_GRAIN (512)
+
 /**
  * May use asynchronous code.
- * Note that in such code, the only shared variables used by
- * threads are P1 and G1. P1 is always wrapped by a locking method
- * insert_critical, and G1 is always sent as a const argument to
- * is_pmc, so it should be fine.
+ * Both loops are split into OpenMP tasks (taskloop), which idle threads
+ * take from the team's task pool. The inner loop over D2 is split into
+ * tasks of its own when D2 is large.
+ * Note that in such code, the only shared state written by threads is the
+ * keep_running / out_of_time flags, which are atomic. Each thread collects
+ * the PMCs it finds in its own buffer, and the buffers are merged into P1
+ * after each parallel region (unless PMCs are reported, see found_pmc).
+ * G1 is always sent as a const argument to is_pmc, so it should be fine.
  * 'a' is only read.
  */
 NodeSetSet PMCEnumerator::one_more_vertex(
                   const SubGraph& G1, const SubGraph& G2, Node a,
                   const NodeSetSet& D1, const NodeSetSet& D2,
-                  const NodeSetSet& P2) {
+                  const NodeSetSet& P2, const PMCVisitor* report) {
     NodeSetSet P1;
-    bool keep_running = true;   // For async code
+    AtomicFlag keep_running(true);   // For async code
+    AtomicFlag sorted_input(true);   // Cleared by VERIFY_SORT_OMV
 
     // If a supports d(a)=0, then the regular algorithm won't add
     // {a} as a PMC, even though it should.
@@ -361,98 +449,158 @@ NodeSetSet PMCEnumerator::one_more_vertex(
     if (G1.d(a) == 0) {
         P1=P2;
         P1.insert(NodeSet({a}));
+        if (report) {
+            for (auto it = P1.begin(); it != P1.end(); ++it) {
+                (*report)(*it);
+            }
+        }
         return P1;
     }
 
+    // One result buffer per thread. When reporting, PMCs go straight to P1
+    // instead, so each one is reported once, as soon as it's found.
+    vector<NodeSetSet> found(allow_parallel ? omp_get_max_threads() : 1);
+    auto found_pmc = [&](const NodeSet& K) {
+        if (!report) {
+            found[omp_get_thread_num()].insert(K);
+            return;
+        }
+        #pragma omp critical(pmce_report)
+        {
+            if (!P1.isMember(K)) {
+                P1.insert(K);
+                (*report)(K);
+            }
+        }
+    };
+
     TRACE(TRACE_LVL__NOISE, "Starting first parallel loop...");
 
+    vector<const NodeSet*> P2vec;
+    P2vec.reserve(P2.size());
+    for (auto pmc2it=P2.begin(); pmc2it != P2.end(); ++pmc2it) {
+        P2vec.push_back(&*pmc2it);
+    }
+
     #pragma omp parallel if(allow_parallel)
+    #pragma omp single
     {
-        for (auto pmc2it=P2.begin(); keep_running && pmc2it != P2.end(); ++pmc2it) {
-            #pragma omp single nowait
-            {
-                auto potential = *pmc2it;
-                if (is_pmc(potential, G1)) {
-                    utils__insert_critical(potential, P1);
-                }
-                else {
-                    NodeSet pmc2a = potential;
-                    pmc2a.insert(pmc2a.end(), a); // should already be sorted as a is bigger than previous nodes
-                    if (is_pmc(pmc2a, G1)) {
-                        utils__insert_critical(pmc2a, P1);
-                    }
-                }
-                #pragma omp critical
-                {
-                    CHECK_TIME_OR_OP(keep_running = false);
+        #pragma omp taskloop grainsize(PMCE_P2_GRAIN)
+        for (long k=0; k<(long)P2vec.size(); ++k) {
+            if (!keep_running) {
+                continue;
+            }
+            const NodeSet& potential = *P2vec[k];
+            if (is_pmc(potential, G1)) {
+                found_pmc(potential);
+            }
+            else {
+                NodeSet pmc2a = potential;
+                pmc2a.insert(pmc2a.end(), a); // should already be sorted as a is bigger than previous nodes
+                if (is_pmc(pmc2a, G1)) {
+                    found_pmc(pmc2a);
                 }
             }
+            CHECK_TIME_OR_OP(keep_running = false);
         }
     }
-    CHECK_TIME_OR_OP(return P1);
+    CHECK_TIME_NOW_OR_OP(merge_thread_buffers(found, P1); return P1);
 
     TRACE(TRACE_LVL__NOISE, "Done with first parallel loop, starting second...");
 
-    #pragma omp parallel if(allow_parallel)
-    {
-        for (auto Sit = D1.begin(); keep_running && Sit != D1.end(); ++Sit) {
-            #pragma omp single nowait
-            {
-                // Sort S first so we can easily compare P=S later.
-                NodeSet S = *Sit;
-                NodeSet Sa = S;
-                VERIFY_SORT_OMV(Sa);
-
-                // Add a, if not already in:
-                if (!UTILS__IS_IN_SORTED_CONTAINER(a,Sa)) {
-                    Sa.insert(Sa.end(), a);
-                }
-                if (is_pmc(Sa, G1)) {
-                    utils__insert_critical(Sa, P1);
-                }
-                if (!UTILS__IS_IN_SORTED_CONTAINER(a,S) && !D2.isMember(S)) {
+    // Every T in D2 is intersected with many components, so keep D2 as bitsets
+    vector<DynamicNodeBitSet> D2bits;
+    D2bits.reserve(D2.size());
+    for (auto sep2 = D2.begin(); sep2 != D2.end(); ++sep2) {
+        D2bits.push_back(DynamicNodeBitSet(*sep2));
+    }
+    bool split_D2 = allow_parallel && D2bits.size() > PMCE_D2_GRAIN;
 
-                    // For each separator S, iterate over all full components C of G
-                    // associated with S. In other words, all connected components C
-                    // of G\S so that the set P of all elements of S that are adjacent
-                    // to some vertex of C supports P=S.
+    vector<const NodeSet*> D1vec;
+    D1vec.reserve(D1.size());
+    for (auto Sit = D1.begin(); Sit != D1.end(); ++Sit) {
+        D1vec.push_back(&*Sit);
+    }
 
-                    BlockVec blocks = G1.getBlocks(S);
-                    for (unsigned int i=0; keep_running && i<blocks.size(); ++i) {
-                        // We only want full components
-                        if (S != blocks[i]->S) {
-                            continue;
+    #pragma omp parallel if(allow_parallel)
+    #pragma omp single
+    {
+        #pragma omp taskloop grainsize(PMCE_D1_GRAIN)
+        for (long k=0; k<(long)D1vec.size(); ++k) {
+            if (!keep_running) {
+                continue;
+            }
+            // Sort S first so we can easily compare P=S later.
+            const NodeSet& S = *D1vec[k];
+            NodeSet Sa = S;
+            VERIFY_SORT_OMV(Sa);
+
+            // Add a, if not already in:
+            if (!UTILS__IS_IN_SORTED_CONTAINER(a,Sa)) {
+                Sa.insert(Sa.end(), a);
+            }
+            if (is_pmc(Sa, G1)) {
+                found_pmc(Sa);
+            }
+            if (!UTILS__IS_IN_SORTED_CONTAINER(a,S) && !D2.isMember(S)) {
+
+                // For each separator S, iterate over all full components C of G
+                // associated with S. In other words, all connected components C
+                // of G\S so that the set P of all elements of S that are adjacent
+                // to some vertex of C supports P=S.
+
+                ComponentScan scan;
+                G1.scanComponents(S, scan);
+                DynamicNodeBitSet Sbits(S);
+                for (int i=0; keep_running && i<scan.size(); ++i) {
+                    // We only want full components
+                    if (!scan.isFull(i)) {
+                        continue;
+                    }
+                    DynamicNodeBitSet C(scan.component(i), scan.getWordsPerRow());
+                    auto check_T = [&](long t) {
+                        if (!keep_running) {
+                            return;
+                        }
+                        NodeSet SuTcapC = ((D2bits[t] & C) |= Sbits).toNodeSet();
+                        if (is_pmc(SuTcapC, G1)) {
+                            found_pmc(SuTcapC);
                         }
-                        for (auto sep2 = D2.begin(); keep_running && sep2 != D2.end(); ++sep2) {
-                            VERIFY_SORT_OMV(*sep2);
-                            VERIFY_SORT_OMV(blocks[i]->C);
-                            NodeSet TcapC;
-                            UTILS__VECTOR_INTERSECTION(*sep2, blocks[i]->C, TcapC);
-                            VERIFY_SORT_OMV(TcapC);
-                            NodeSet SuTcapC;
-                            UTILS__VECTOR_UNION(TcapC, S, SuTcapC);  // S is verified sorted (above)
-                            VERIFY_SORT_OMV(SuTcapC);
-                            if (is_pmc(SuTcapC, G1)) {
-                                utils__insert_critical(SuTcapC, P1);
-                            }
-                            #pragma omp critical
-                            {
-                                CHECK_TIME_OR_OP(keep_running = false);
-                            }
+                        CHECK_TIME_OR_OP(keep_running = false);
+                    };
+                    if (split_D2) {
+                        #pragma omp taskloop grainsize(PMCE_D2_GRAIN)
+                        for (long t=0; t<(long)D2bits.size(); ++t) {
+                            check_T(t);
+                        }
+                    }
+                    else {
+                        for (long t=0; keep_running && t<(long)D2bits.size(); ++t) {
+                            check_T(t);
                         }
                     }
-                }
-                #pragma omp critical
-                {
-                    CHECK_TIME_OR_OP(keep_running = false);
                 }
             }
+            CHECK_TIME_OR_OP(keep_running = false);
         }
     }
+    merge_thread_buffers(found, P1);
 
+    if (!sorted_input) {
+        return NodeSetSet();
+    }
     return P1;
 }
 
+void PMCEnumerator::merge_thread_buffers(vector<NodeSetSet>& buffers, NodeSetSet& out) {
+    for (unsigned i=0; i<buffers.size(); ++i) {
+        for (auto it = buffers[i].begin(); it != buffers[i].end(); ++it) {
+            out.insert(*it);
+        }
+        buffers[i].clear();
+    }
+}
+
 /**
  * Uses theorem 8 in the paper.
  *
@@ -473,69 +621,20 @@ NodeSetSet PMCEnumerator::one_more_vertex(
  * Ci apart from the endpoints x and y.
  */
 
-bool PMCEnumerator::is_pmc(NodeSet K, const SubGraph& G) {
-	BlockVec B = G.getBlocks(K);
-	unsigned int i,j,k;
-
-
-    // Sort K so we can compare it easily to other vectors
-    //std::sort(K.begin(), K.end());
-
-    // Build the sets Si.
-    // While doing so make sure we don't have any full components
-    for (i=0; i<B.size(); ++i) {
-        VERIFY_SORT_ISPMC(B[i]->S); // S must be sorted for the algorithm to work
-        if (B[i]->S == K) {
-            // Uh oh.. C[i] is a full component
-            return false;
-        }
-        CHECK_TIME_OR_OP(return false);
-    }
-
-    // For each x,y in K (that aren't equal) we need to check if
-    // they're neighbors in G or both contained in some Si.
-    for (i=0; i<K.size(); ++i) {
-        Node x = K[i];
-        // Find the S[i]s containing x
-        vector<NodeSet> Sx;
-        for (j=0; j<B.size(); ++j) {
-            CHECK_TIME_OR_OP(return false);
-            // They're all sorted, so use binary search
-            if (UTILS__IS_IN_SORTED_CONTAINER(x, B[j]->S)) {
-                Sx.push_back(B[j]->S);
-            }
-        }
-        // For every unchecked y in K (scanning forward) check adjacency
-        // in the graph F
-        for (j=i+1; j<K.size(); ++j) {
-            CHECK_TIME_OR_OP(return false);
-            Node y = K[j];
-            if (G.areNeighbors(x, y)) {
-                continue;
-            }
-            bool foundSi = false;
-            for (k=0; k<Sx.size(); ++k) {
-                // Sx is sorted by construction (otherwise, S is unsorted),
-                // so IS_IN_CONTAINER can be safely used.
-                if (UTILS__IS_IN_SORTED_CONTAINER(y, Sx[k])) {
-                    foundSi = true;
-                    break;
-                }
-                CHECK_TIME_OR_OP(return false);
-            }
-            if (!foundSi) {
-                // x and y aren't connected in F...
-                return false;
-            }
-        }
-    }
-
-    return true;
+bool PMCEnumerator::is_pmc(const NodeSet& K, const SubGraph& G) {
+    CHECK_TIME_OR_OP(return false);
+    // is_pmc runs several times per candidate, on every thread, so each
+    // thread keeps its own scan buffers.
+    static thread_local ComponentScan scan;
+    return G.isPotentialMaximalClique(K, scan);
 }
 
 bool PMCEnumerator::is_out_of_time() const {
     return out_of_time;
 }
+bool PMCEnumerator::is_cancelled() const {
+    return cancel_token.is_cancelled();
+}
 
 } /* namespace tdenum */
 
@@ -6,6 +6,8 @@
 #include "PMCAlg.h"
 #include "StatisticRequest.h"
 #include "SubGraph.h"
+#include "Utils.h"
+#include <functional>
 #include <omp.h>
 #include <vector>
 
@@ -19,6 +21,9 @@ typedef enum PMCERunMode {
 } PMCERunMode;
 extern int PMCE_RUNMODE;
 
+// Receives PMCs (see PMCEnumerator::visit()).
+typedef std::function<void(const NodeSet&)> PMCVisitor;
+
 /**
  * Constructs a list of potential maximal cliques, given a graph.
  *
@@ -56,6 +61,11 @@ private:
     vector<NodeSetSet> ms_subgraphs;
     vector<long> ms_subgraph_count;
 
+    // If false, the separators of the subgraphs aren't kept (only counted),
+    // and each level is released once the PMC iteration is done with it.
+    // The NORMAL algorithms then hold only two levels at a time.
+    bool store_ms_subgraphs;
+
     // If this is set to true, OMP #pragmas will be activated.
     bool allow_parallel;
     omp_lock_t lock;
@@ -63,29 +73,43 @@ private:
     // If the calculation is complete, set this to true.
     bool done;
 
-    // If time limit exceeded, we need to know.
-    time_t limit;
-    time_t start_time;
-    bool out_of_time;
+    // If time limit (in seconds) exceeded, we need to know.
+    // out_of_time may be set by any of the worker threads.
+    double limit;
+    Deadline deadline;
+    AtomicFlag out_of_time;
+
+    // Stops the calculation from outside (see set_cancellation_token()).
+    CancellationToken cancel_token;
+
+    // If set, the PMCs of the graph are reported here instead of being kept
+    // (see visit()).
+    const PMCVisitor* visitor;
 
     // Call to reset members to default values.
     void set_default_member_vals();
 
     // Returns true <==> K is a potential maximal clique in G.
     // Assumes K is a subset of the vertices in G.
-    bool is_pmc(NodeSet K, const SubGraph& G);
+    bool is_pmc(const NodeSet& K, const SubGraph& G);
 
     // The iterative step of the algorithm.
     // Given graphs G1, G2, a vertex 'a' s.t. G2=G1\{a}, the minimal
     // seperators D1, D2 of G1 and G2 respectively and the potential
     // maximal cliques P2 of G2, calculates the set of potential maximal
     // cliques of G1 in polynomial time.
+    // If report is given, each PMC of G1 is also passed to it (once) as
+    // soon as it's found.
     NodeSetSet one_more_vertex(const SubGraph& G1,
                                const SubGraph& G2,
                                Node a,
                                const NodeSetSet& D1,
                                const NodeSetSet& D2,
-                               const NodeSetSet& P2);
+                               const NodeSetSet& P2,
+                               const PMCVisitor* report = NULL);
+
+    // Moves the contents of the per-thread result buffers into out.
+    void merge_thread_buffers(vector<NodeSetSet>& buffers, NodeSetSet& out);
 
     // Reads the totals, given an updated ms_subgraphs field
     void update_ms_subgraph_count();
@@ -96,20 +120,27 @@ private:
 public:
 
     // Construct the enumerator with the given graph.
-    // Optionally, enforce a time limit.
-    PMCEnumerator(const Graph& g, time_t time_limit = 0);
+    // Optionally, enforce a time limit (in seconds, fractions allowed).
+    PMCEnumerator(const Graph& g, double time_limit = 0);
     ~PMCEnumerator();
 
     // Resets the instance to use a new graph (allows re-use of variable name).
-    PMCEnumerator& reset(const Graph& g, time_t time_limit = 0);
+    PMCEnumerator& reset(const Graph& g, double time_limit = 0);
 
     // Setters / getters
     PMCEnumerator& set_algorithm(PMCAlg a);
     PMCAlg get_alg() const;
-    PMCEnumerator& set_time_limit(time_t);
+    PMCEnumerator& set_time_limit(double);
     PMCEnumerator& unset_time_limit();
     PMCEnumerator& enable_parallel();
     PMCEnumerator& suppress_parallel();
+    // Enabled by default. If suppressed, get_ms_subgraphs() returns an empty
+    // vector, but get_ms_count_subgraphs() is still valid.
+    PMCEnumerator& enable_ms_subgraphs();
+    PMCEnumerator& suppress_ms_subgraphs();
+    // Once the token is cancelled the calculation stops as if it were out of
+    // time. PMCs already passed to a visitor remain valid.
+    PMCEnumerator& set_cancellation_token(const CancellationToken&);
 
     // If the minimal separators for the original graph has already been
     // calculated, inform the enumerator.
@@ -120,6 +151,19 @@ public:
     // Uses the algorithm specified by the user.
     NodeSetSet get(/*const StatisticRequest&*/);
 
+    // Passes each PMC of the graph (once) to the visitor as soon as it's
+    // found, instead of collecting all of them. The PMCs of the last
+    // iteration aren't kept, so a later get() recalculates them.
+    // Calls to the visitor are serialized, even in parallel mode.
+    // Returns false if the time limit was reached (the PMCs reported so far
+    // are valid, but some may be missing).
+    bool visit(const PMCVisitor& visitor);
+
+    // Writes the PMCs to the given file as they are found (see
+    // NodeSetFileWriter). Returns false on time out, or if the file couldn't
+    // be opened.
+    bool spill(const string& filename);
+
     // Return the set of minimal separators.
     NodeSetSet get_ms();
     vector<NodeSetSet> get_ms_subgraphs();
@@ -128,8 +172,10 @@ public:
     // Returns the underlying graph
     Graph get_graph() const;
 
-    // If true, the calculation couldn't be completed in the allowed time.
+    // If true, the calculation couldn't be completed in the allowed time
+    // (or was cancelled).
     bool is_out_of_time() const;
+    bool is_cancelled() const;
 };
 
 } /* namespace tdenum */
@@ -3,11 +3,13 @@
 #include "GraphProducer.h"
 #include "GraphReader.h"
 #include "GraphStats.h"
+#include "MinimalSeparatorsEnumerator.h"
 #include "MinimalTriangulationsEnumerator.h"
 #include "PMCEnumeratorTester.h"
 #include "PMCEnumerator.h"
 #include "StatisticRequest.h"
 #include "Utils.h"
+#include <algorithm>
 #include <unistd.h>
 
 namespace tdenum {
@@ -541,6 +543,203 @@ bool PMCEnumeratorTester::algorithmconsistencyparallel() const {
     return algorithmconsistency_aux(true);
 }
 
+bool PMCEnumeratorTester::parallelminimalseparators() const {
+    auto gs = GraphProducer()
+                .add_random({2,6,10,14,18,22},{0.2,0.4,0.6,0.8}, true)
+                .get();
+    for (unsigned i=0; i<gs.size(); ++i) {
+        const Graph& g = gs[i].get_graph();
+        NodeSetSet ms, parallel_ms;
+        ASSERT(MinimalSeparatorsEnumerator(g, UNIFORM).getAll(ms));
+        ASSERT(MinimalSeparatorsEnumerator(g, UNIFORM).enable_parallel().getAll(parallel_ms));
+        ASSERT_EQ(ms.size(), parallel_ms.size());
+        ASSERT(ms == parallel_ms);
+    }
+    return true;
+}
+
+bool PMCEnumeratorTester::suppressedmssubgraphs() const {
+    auto gs = GraphProducer()
+                .add_random({2,5,8,11,14},{0.3,0.5,0.7}, true)
+                .get();
+    for (unsigned i=0; i<gs.size(); ++i) {
+        const Graph& g = gs[i].get_graph();
+        for (int alg = PMCAlg::first(); alg<PMCAlg::last(); ++alg) {
+            PMCEnumerator pmce(g), streaming_pmce(g);
+            pmce.set_algorithm(PMCAlg(alg));
+            streaming_pmce.set_algorithm(PMCAlg(alg)).suppress_ms_subgraphs();
+            ASSERT(pmce.get() == streaming_pmce.get());
+            // Random renaming yields different subgraphs in each run
+            if (!PMCAlg(alg).is_random_node_rename()) {
+                ASSERT_EQ(pmce.get_ms_count_subgraphs(), streaming_pmce.get_ms_count_subgraphs());
+            }
+            ASSERT_EQ(streaming_pmce.get_ms_subgraphs().size(), (unsigned)0);
+        }
+    }
+    return true;
+}
+
+bool PMCEnumeratorTester::visitor() const {
+    auto gs = GraphProducer()
+                .add_random({1,2,5,8,11,14},{0.3,0.5,0.7}, true)
+                .get();
+    string filename = tmp_dir_name+"/pmcs.bin";
+    for (unsigned i=0; i<gs.size(); ++i) {
+        const Graph& g = gs[i].get_graph();
+        for (int alg = PMCAlg::first(); alg<PMCAlg::last(); ++alg) {
+            PMCEnumerator pmce(g);
+            pmce.set_algorithm(PMCAlg(alg));
+            if (PMCAlg(alg).is_parallel()) {
+                pmce.enable_parallel();
+            }
+            NodeSetSet pmcs = PMCEnumerator(g).get();
+            NodeSetSet visited;
+            long calls = 0;
+            ASSERT(pmce.visit([&](const NodeSet& K) { visited.insert(K); ++calls; }));
+            ASSERT_EQ(calls, long(pmcs.size()));
+            ASSERT(visited == pmcs);
+
+            ASSERT(pmce.spill(filename));
+            NodeSetFileReader reader(filename);
+            NodeSet K;
+            NodeSetSet spilled;
+            while (reader.read(K)) {
+                spilled.insert(K);
+            }
+            ASSERT(spilled == pmcs);
+        }
+    }
+    return true;
+}
+
+bool PMCEnumeratorTester::fractionaltimelimit() const {
+    // The full calculation takes several seconds
+    Graph g(30);
+    g.randomize(0.3);
+    for (int alg = PMCAlg::first(); alg<PMCAlg::last(); ++alg) {
+        PMCEnumerator pmce(g, 0.1);
+        pmce.set_algorithm(PMCAlg(alg));
+        if (PMCAlg(alg).is_parallel()) {
+            pmce.enable_parallel();
+        }
+        Deadline timer;
+        pmce.get();
+        ASSERT(pmce.is_out_of_time());
+        ASSERT_LEQ(timer.elapsed(), 1.5);
+    }
+    return true;
+}
+
+bool PMCEnumeratorTester::cancellation() const {
+    Graph g(20);
+    g.randomize(0.3);
+    NodeSetSet pmcs = PMCEnumerator(g).get();
+    NodeSetSet ms;
+    ASSERT(MinimalSeparatorsEnumerator(g, UNIFORM).getAll(ms));
+    ASSERT_GEQ(ms.size(), 3);
+
+    // Cancelled in advance
+    CancellationToken token;
+    token.cancel();
+    PMCEnumerator cancelled_pmce(g);
+    cancelled_pmce.set_cancellation_token(token);
+    ASSERT_EQ(cancelled_pmce.get(), NodeSetSet());
+    ASSERT(cancelled_pmce.is_out_of_time());
+    ASSERT(cancelled_pmce.is_cancelled());
+
+    // Cancelled by the visitor, after a few PMCs
+    for (int alg = PMCAlg::first(); alg<PMCAlg::last(); ++alg) {
+        CancellationToken pmc_token;
+        PMCEnumerator pmce(g);
+        pmce.set_algorithm(PMCAlg(alg)).set_cancellation_token(pmc_token);
+        NodeSetSet visited;
+        ASSERT(!pmce.visit([&](const NodeSet& K) {
+            visited.insert(K);
+            if (visited.size() == 3) {
+                pmc_token.cancel();
+            }
+        }));
+        ASSERT(pmce.is_cancelled());
+        ASSERT_GEQ(visited.size(), 3);
+        for (auto it = visited.begin(); it != visited.end(); ++it) {
+            ASSERT(pmcs.isMember(*it));
+        }
+    }
+
+    // Minimal separators: the ones returned before cancelling are kept
+    for (int parallel=0; parallel<2; ++parallel) {
+        CancellationToken ms_token;
+        MinimalSeparatorsEnumerator mse(g, UNIFORM);
+        mse.setCancellationToken(ms_token);
+        if (parallel) {
+            mse.enable_parallel();
+        }
+        NodeSetSet partial;
+        partial.insert(mse.next());
+        ms_token.cancel();
+        ASSERT(!mse.hasNext());
+        ASSERT(!mse.getAll(partial));
+        ASSERT_EQ(partial.size(), 1);
+        ASSERT(ms.isMember(*partial.begin()));
+    }
+
+    // Triangulations
+    CancellationToken trng_token;
+    MinimalTriangulationsEnumerator mte(g, NONE, UNIFORM, MCS_M);
+    mte.setCancellationToken(trng_token);
+    ASSERT(mte.hasNext());
+    mte.next();
+    trng_token.cancel();
+    ASSERT(!mte.hasNext());
+    return true;
+}
+
+// The definition: no full block, and every x,y in K are neighbors or in
+// the separator of the same block.
+bool is_pmc_pairwise(const NodeSet& K, const Graph& g) {
+    BlockVec blocks = g.getBlocks(K);
+    for (unsigned b=0; b<blocks.size(); ++b) {
+        if (blocks[b]->S.size() == K.size()) {
+            return false;
+        }
+    }
+    for (unsigned i=0; i<K.size(); ++i) {
+        for (unsigned j=i+1; j<K.size(); ++j) {
+            bool connected = g.areNeighbors(K[i], K[j]);
+            for (unsigned b=0; !connected && b<blocks.size(); ++b) {
+                const NodeSet& S = blocks[b]->S;
+                connected = std::binary_search(S.begin(), S.end(), K[i]) &&
+                            std::binary_search(S.begin(), S.end(), K[j]);
+            }
+            if (!connected) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+bool PMCEnumeratorTester::pmckernel() const {
+    auto gs = GraphProducer()
+                .add_random({1,2,5,9},{0.2,0.5,0.8}, true)
+                .get();
+    for (unsigned i=0; i<gs.size(); ++i) {
+        const Graph& g = gs[i].get_graph();
+        PMCEnumerator pmce(g);
+        int n = g.getNumberOfNodes();
+        for (int mask=0; mask < (1<<n); ++mask) {
+            NodeSet K;
+            for (int v=0; v<n; ++v) {
+                if (mask & (1<<v)) {
+                    K.push_back(v);
+                }
+            }
+            ASSERT_EQ(pmce.is_pmc(K, g), is_pmc_pairwise(K, g));
+        }
+    }
+    return true;
+}
+
 bool crosscheck_aux(const GraphStats& gs) {
     // Iterate over all maximal cliques in all triangulations.
     // Make sure each one is in the NodeSetSet returned by the
@@ -37,6 +37,24 @@
        Test both synchronous and asynchronous modes in the PMC enumerator. */ \
     X(algorithmconsistencysync) \
     X(algorithmconsistencyparallel) \
+    /* The parallel minimal separator enumeration (used by the parallel \
+       PMC algorithms) should find the same separators. */ \
+    X(parallelminimalseparators) \
+    /* Without storing the separators of the subgraphs, the PMCs and the \
+       separator counts should be the same. */ \
+    X(suppressedmssubgraphs) \
+    /* PMCs reported to a visitor / spilled to a file should be the same \
+       as the ones returned by get(), each reported once. */ \
+    X(visitor) \
+    /* The bitset PMC test should agree with the pairwise definition, for \
+       every node subset of some random graphs. */ \
+    X(pmckernel) \
+    /* Time limits may be fractions of a second, and should stop the \
+       calculation (of every algorithm) promptly. */ \
+    X(fractionaltimelimit) \
+    /* A cancelled token stops the PMC, separator and triangulation \
+       enumerators, and the results found so far remain valid. */ \
+    X(cancellation) \
     /* Uses existing datasets and Nofar's code to cross-check the PMC \
        algorithm with Nofar's version */ \
     X(crosscheck)
@@ -35,6 +35,7 @@ void PMCRacer::add_all_algs() { algs = PMCAlg::get_all(); }
 */
 void PMCRacer::set_debug() { debug = true; }
 void PMCRacer::unset_debug() { debug = false; }
+void PMCRacer::set_cancellation_token(const CancellationToken& token) { cancel_token = token; }
 
 bool PMCRacer::go(const StatisticRequest& sr, bool verbose) {
 
@@ -53,37 +54,36 @@ bool PMCRacer::go(const StatisticRequest& sr, bool verbose) {
         // To save time, since all algorithms require the calculation of all minimal
         // separators, start by calculating them in advance. Add the time required to
         // the total time.
-        // To enforce the time limit, calculate the separators one by one.
-        time_t start_time = time(NULL);
+        // The deadline stops the separators calculation once the time limit
+        // passes.
+        Deadline deadline;
+        if (sr.test_time_limit_pmc()) {
+            deadline.set_strict_limit(sr.get_time_limit_pmc());
+        }
         bool time_limit_exceeded = false;
         MinimalSeparatorsEnumerator mse(gs[i].get_graph(), UNIFORM);
+        mse.setCancellationToken(cancel_token);
         NodeSetSet min_seps;
-        time_t ms_calc_time=0;
         try {
-            while(mse.hasNext()) {
-                min_seps.insert(mse.next());
-                ms_calc_time = difftime(time(NULL),start_time);
-                if (sr.test_time_limit_pmc() && ms_calc_time > sr.get_time_limit_pmc()) {
-                    time_limit_exceeded = true;
-                    break;
-                }
-            }
+            time_limit_exceeded = !mse.getAll(min_seps, deadline) && !cancel_token.is_cancelled();
         }
         catch(std::bad_alloc) {
             TRACE(TRACE_LVL__ERROR, "Out of memory calculating minimal separators...");
             gs[i].set_mem_error_ms();
-            gs[i].set_pmc_calc_time(algs, ms_calc_time);
+            gs[i].set_pmc_calc_time(algs, deadline.elapsed());
             continue;
         }
+        double ms_calc_time = deadline.elapsed();
+        if (sr.test_time_limit_pmc() && ms_calc_time >= sr.get_time_limit_pmc()) {
+            time_limit_exceeded = true;
+        }
 
         // Keep calculating. Now, the remaining time can be used by each algorithm
         // separately.
         UTILS__PRINT_IF(verbose, "MS calc time: " << utils__timestamp_to_hhmmss(ms_calc_time));
-        // time_remaining may be garbage if sr.test_time_limit_pmc() == false
-        time_t time_remaining_for_pmcs = difftime(sr.get_time_limit_pmc(true),ms_calc_time);
-        if (time_remaining_for_pmcs <= 0) {
-            time_remaining_for_pmcs = 1;
-        }
+        // time_remaining is only used if sr.test_time_limit_pmc() (and is
+        // positive if the time limit wasn't exceeded)
+        double time_remaining_for_pmcs = sr.get_time_limit_pmc(true) - ms_calc_time;
 
         // If the initial MS calculation took too long, all algorithms would be
         // too long.
@@ -91,7 +91,13 @@ bool PMCRacer::go(const StatisticRequest& sr, bool verbose) {
         if (time_limit_exceeded) {
             UTILS__PRINT_IF(verbose, "Out of time in initial MS calculation, moving on to the next graph.");
             gs[i].set_reached_time_limit_pmc(utils__vector_to_set(algs));
-            gs[i].set_pmc_calc_time(algs,sr.get_time_limit_pmc()+1);
+            gs[i].set_pmc_calc_time(algs, ms_calc_time);
+            continue;
+        }
+        if (cancel_token.is_cancelled()) {
+            UTILS__PRINT_IF(verbose, "Cancelled, moving on to the next graph.");
+            gs[i].set_reached_time_limit_pmc(utils__vector_to_set(algs));
+            gs[i].set_pmc_calc_time(algs, ms_calc_time);
             continue;
         }
 
@@ -122,8 +128,12 @@ bool PMCRacer::go(const StatisticRequest& sr, bool verbose) {
             PMCEnumerator pmce(gs[i].get_graph());
             TRACE(TRACE_LVL__TEST, "Set algorithm for the PMCE");
             pmce.set_algorithm(alg);
+            pmce.set_cancellation_token(cancel_token);
+            if (!sr.test_ms_subgraphs()) {
+                pmce.suppress_ms_subgraphs();
+            }
             NodeSetSet pmcs;
-            time_t inner_start_time = time(NULL);
+            Deadline pmc_timer;
             try {
                 if (gs[i].get_graph().getNumberOfNodes() > 0) {
                     pmce.set_minimal_separators(min_seps);
@@ -138,8 +148,7 @@ bool PMCRacer::go(const StatisticRequest& sr, bool verbose) {
                 gs[i].set_mem_error_pmc(alg);
                 continue;
             }
-            time_t pmc_calc_time_without_ms = difftime(time(NULL), inner_start_time);
-            time_t pmc_calc_time_with_ms = pmc_calc_time_without_ms + ms_calc_time;
+            double pmc_calc_time_with_ms = pmc_timer.elapsed() + ms_calc_time;
             TRACE(TRACE_LVL__TEST, "Ran PMCE, total (including MS) is " << utils__timestamp_to_hhmmss(pmc_calc_time_with_ms));
 
             // Error checking
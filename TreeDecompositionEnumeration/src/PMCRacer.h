@@ -38,6 +38,9 @@ private:
     // Flag for debugging (inner crosscheck functionality)
     bool debug;
 
+    // Stops the race from outside (see set_cancellation_token())
+    CancellationToken cancel_token;
+
     // The algorithms to use
 //    vector<PMCAlg> algs;
 
@@ -72,6 +75,10 @@ public:
     void set_debug();
     void unset_debug();
 
+    // Once the token is cancelled, the remaining calculations stop and are
+    // reported as out of time.
+    void set_cancellation_token(const CancellationToken&);
+
     // Race! Optionally, print stuff to console.
     // If append_results is set to true, results will be appended
     // as new rows in the CSV file.
@@ -107,14 +107,14 @@ bool PMCRacerTester::validate_accurate_times_basic() {
     StatisticRequest sr = StatisticRequest().set_single_pmc_alg(PMCALG_ENUM_NORMAL).set_pmc().set_count_pmc();
     PMCEnumerator pmce(gs.get_graph());
     pmce.set_algorithm(PMCALG_ENUM_NORMAL);
-    time_t start_time = time(NULL);
+    Deadline timer;
     NodeSetSet pmcs = pmce.get(/*sr*/);
-    time_t expected_pmc_time = difftime(time(NULL), start_time);
+    double expected_pmc_time = timer.elapsed();
     UTILS__PRINT_IF(verbose, "PMCEnumerator time: " << utils__timestamp_to_hhmmss(expected_pmc_time));
     PMCRacer pmcr("",false);
     pmcr.add(gs);
     pmcr.go(sr, verbose);
-    time_t racer_time = pmcr.get_stats()[0].get_pmc_calc_time(PMCALG_ENUM_NORMAL);
+    double racer_time = pmcr.get_stats()[0].get_pmc_calc_time(PMCALG_ENUM_NORMAL);
     UTILS__PRINT_IF(verbose, "PMCRacer time: " << utils__timestamp_to_hhmmss(racer_time));
 
     ASSERT_GEQ(1.2*expected_pmc_time, racer_time);
@@ -130,20 +130,20 @@ bool PMCRacerTester::validate_accurate_times_basic_twoalgs() {
                                             .set_pmc()
                                             .set_count_pmc();
     ASSERT_GEQ(sr.get_active_pmc_algs().size(), 2);
-    map<PMCAlg, time_t> pmce_times;
+    map<PMCAlg, double> pmce_times;
     for (PMCAlg alg: sr.get_active_pmc_algs_vector()) {
         PMCEnumerator pmce(gs.get_graph());
         pmce.set_algorithm(alg);
-        time_t start_time = time(NULL);
+        Deadline timer;
         NodeSetSet pmcs = pmce.get(/*sr*/);
-        pmce_times[alg] = difftime(time(NULL), start_time);
+        pmce_times[alg] = timer.elapsed();
         UTILS__PRINT_IF(verbose, "PMCEnumerator time: " << utils__timestamp_to_hhmmss(pmce_times.at(alg)) << " for alg " << alg.str());
     }
     PMCRacer pmcr("",false);
     pmcr.add(gs);
     pmcr.go(sr);
     GraphStats out = pmcr.get_stats()[0];
-    map<PMCAlg, time_t> racer_times;
+    map<PMCAlg, double> racer_times;
     for (PMCAlg alg: sr.get_active_pmc_algs_vector()) {
         racer_times[alg] = out.get_pmc_calc_time(alg);
         UTILS__PRINT_IF(verbose, "PMCRacer time: " << utils__timestamp_to_hhmmss(racer_times[alg]) << " for alg " << alg.str());
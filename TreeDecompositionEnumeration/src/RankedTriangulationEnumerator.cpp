@@ -3,48 +3,137 @@
 
 namespace tdenum {
 
-	RankedTriangulationsEnumerator::RankedTriangulationsEnumerator(const Graph& G, TriangulationEvaluator* eval) :
-		triangulator(G), resultQueue() {
+// Number of elements per chunk when evaluating the split elements in parallel
+#define RTE_BRANCH_GRAIN (1)
+
+	RankedTriangulationsEnumerator::RankedTriangulationsEnumerator(const Graph& G, TriangulationEvaluator* eval,
+			const CancellationToken& token) :
+		triangulator(G, token), rootEval(NULL), resultQueue(), returned(),
+		cancelToken(token), maxResults(0), allow_parallel(false) {
 		eval->resizeByNumBlocks(triangulator.getNumBlocks());
-		resultQueue.push_back(triangulator.triangulate(eval));
+		if (triangulator.isCancelled()) {
+			delete eval;
+			return;
+		}
+		rootEval = eval;
+		QueuedResult root;
+		root.cost = triangulator.evaluate(rootEval);
+		root.parent = -1;
+		root.branch = -1;
+		resultQueue.push_back(root);
+	}
+
+	RankedTriangulationsEnumerator::~RankedTriangulationsEnumerator() {
+		delete rootEval;
+	}
+
+	void RankedTriangulationsEnumerator::setMaxResults(int k) {
+		maxResults = k;
+	}
+
+	RankedTriangulationsEnumerator& RankedTriangulationsEnumerator::enable_parallel() {
+		allow_parallel = true;
+		return *this;
+	}
+
+	RankedTriangulationsEnumerator& RankedTriangulationsEnumerator::suppress_parallel() {
+		allow_parallel = false;
+		return *this;
 	}
 
 	bool RankedTriangulationsEnumerator::hasNext() {
+		if (maxResults > 0 && (int)returned.size() >= maxResults)
+			return false;
 		return resultQueue.size() > 0;
 	}
 
+	void RankedTriangulationsEnumerator::getConstraints(const QueuedResult& result,
+			NodeSetSet& inclusions, NodeSetSet& exclusions) const {
+		int branch = result.branch;
+		for (int parent = result.parent; parent >= 0; parent = returned[parent].parent) {
+			const vector<MinimalSeparator>& seps = returned[parent].branchSeps;
+			exclusions.insert(seps[branch]);
+			for (int i = 0; i < branch; i++)
+				inclusions.insert(seps[i]);
+			branch = returned[parent].branch;
+		}
+	}
+
 	ChordalGraph RankedTriangulationsEnumerator::next() {
 		// Remove first element from queue
 		pop_heap(resultQueue.begin(), resultQueue.end());
-		TriangulationResult next = resultQueue.back();
+		QueuedResult popped = resultQueue.back();
 		resultQueue.pop_back();
 
-		// Split this elements into new elements and evaluate them.
-		NodeSetSet newInclusions;
+		// Build the triangulation, by evaluating its constraints again
+		NodeSetSet inclusions, exclusions;
+		getConstraints(popped, inclusions, exclusions);
+		TriangulationResult next =
+			triangulator.triangulate(rootEval->extendEvaluator(inclusions, exclusions));
+		int id = returned.size();
+		returned.push_back(ReturnedResult());
+		returned[id].parent = popped.parent;
+		returned[id].branch = popped.branch;
+		// No need to split the last triangulation to be returned
+		if (maxResults > 0 && (int)returned.size() >= maxResults) {
+			delete next.eval;
+			return next.triangulation;
+		}
 
+		// Split this elements into new elements. The i'th element includes
+		// the first i-1 separators and excludes the i'th one.
+		NodeSetSet newInclusions;
+		vector<TriangulationEvaluator*> newEvals;
+		vector<MinimalSeparator>& branchSeps = returned[id].branchSeps;
 		for (auto sep = next.minSeps.begin(); sep != next.minSeps.end(); sep++) {
 			// If separator in Inclusion set
-			if (next.eval->getInclusionConsts().isMember(*sep))
+			if (next.eval->isInclusionConst(*sep))
 				continue;
 			
 			// Create evaluator with new constraint set 
 			NodeSetSet newExclusions;
 			newExclusions.insert(*sep);
-			TriangulationEvaluator* newEval = next.eval->extendEvaluator(newInclusions, newExclusions);
+			newEvals.push_back(next.eval->extendEvaluator(newInclusions, newExclusions));
+			branchSeps.push_back(*sep);
+
+			newInclusions.insert(*sep);
+		}
+
+		// The elements are independent, so they may be evaluated in parallel
+		// (evaluate() only reads the triangulator). They are then pushed into
+		// the queue in order. Only their costs are kept.
+		vector<float> newCosts(newEvals.size(), CONSTRAINT_VIOLATION);
+		#pragma omp parallel for if(allow_parallel && newEvals.size() > 1) schedule(dynamic, RTE_BRANCH_GRAIN)
+		for (long i = 0; i < (long)newEvals.size(); i++) {
+			if (!cancelToken.is_cancelled())
+				newCosts[i] = triangulator.evaluate(newEvals[i]);
+			delete newEvals[i];
+		}
 
+		for (unsigned int i = 0; i < newCosts.size(); i++) {
 			// Push result of the new constraint set into queue if it is legal
-			TriangulationResult newResult = triangulator.triangulate(newEval);
-			if (newResult.cost != CONSTRAINT_VIOLATION) {
+			if (newCosts[i] != CONSTRAINT_VIOLATION) {
+				QueuedResult newResult;
+				newResult.cost = newCosts[i];
+				newResult.parent = id;
+				newResult.branch = i;
 				resultQueue.push_back(newResult);
 				//cout << "Pushed cost is " << resultQueue.back().cost << endl;
 				push_heap(resultQueue.begin(), resultQueue.end());
 			}
-			else {
-				newResult.eval = NULL;
-				delete newEval;
-			} 
+		}
 
-			newInclusions.insert(*sep);
+		// Keep only the elements that may still be returned
+		if (maxResults > 0) {
+			unsigned int remaining = maxResults - returned.size();
+			if (resultQueue.size() > remaining) {
+				nth_element(resultQueue.begin(), resultQueue.begin() + remaining, resultQueue.end(),
+					[](const QueuedResult& r1, const QueuedResult& r2) {
+					return r1.cost < r2.cost;
+				});
+				resultQueue.resize(remaining);
+				make_heap(resultQueue.begin(), resultQueue.end());
+			}
 		}
 
 		delete next.eval;
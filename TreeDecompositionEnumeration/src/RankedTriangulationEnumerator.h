@@ -16,16 +16,60 @@ namespace tdenum {
 	* Enumerates the minimal triangulations of a graph in ranked order
 	*/
 	class RankedTriangulationsEnumerator {
+		// A triangulation waiting in the queue. Only its cost is kept: its
+		// constraints are those of the parent (a returned triangulation),
+		// with the first branch separators of the parent included and the
+		// next one excluded. The root has no parent.
+		struct QueuedResult {
+			float cost;
+			int parent;
+			int branch;
+			bool operator<(const QueuedResult& rhs) const {
+				return rhs.cost < this->cost;
+			}
+		};
+		// A returned triangulation, and the separators its children split on
+		struct ReturnedResult {
+			int parent;
+			int branch;
+			vector<MinimalSeparator> branchSeps;
+		};
+
 		OptimalMinimalTriangulator triangulator;
-		vector<TriangulationResult> resultQueue;
+		// The evaluator of the unconstrained graph. The evaluators of the
+		// queued triangulations extend it when they're popped.
+		TriangulationEvaluator* rootEval;
+		vector<QueuedResult> resultQueue;
+		vector<ReturnedResult> returned;
+		CancellationToken cancelToken;
+		// If positive, the number of triangulations to return
+		int maxResults;
+		// If true, next() evaluates the split elements in parallel
+		bool allow_parallel;
+
+		// Builds the constraints of the given queued triangulation
+		void getConstraints(const QueuedResult&, NodeSetSet& inclusions,
+			NodeSetSet& exclusions) const;
 
 	public:
 		// initialization
-		RankedTriangulationsEnumerator(const Graph& G, TriangulationEvaluator* eval);
+		// Once the token is cancelled, next() stops looking for further
+		// triangulations (the ones already queued may still be returned).
+		RankedTriangulationsEnumerator(const Graph& G, TriangulationEvaluator* eval,
+			const CancellationToken& token = CancellationToken());
+		~RankedTriangulationsEnumerator();
+		// Returns only the k best triangulations. The queue then keeps only
+		// the triangulations that may still be among them. 0 means no limit.
+		void setMaxResults(int k);
 		// Checks whether there is another minimal triangulation
 		bool hasNext();
 		// Returns another minimal triangulation
 		ChordalGraph next();
+		// Suppressed by default. If enabled, next() evaluates the
+		// triangulations splitting off of the returned one in parallel. The
+		// order of the results is the same either way.
+		RankedTriangulationsEnumerator& enable_parallel();
+		RankedTriangulationsEnumerator& suppress_parallel();
 	};
 
 } /* namespace tdenum */
@@ -0,0 +1,263 @@
+#include "DirectoryIterator.h"
+#include "GraphReader.h"
+#include "MinimalTriangulationsEnumerator.h"
+#include "OptimalMinimalTriangulator.h"
+#include "RankedTriangulationEnumerator.h"
+#include "RankedTriangulationsTester.h"
+#include <cstdlib>
+
+namespace tdenum {
+
+// The subgraph induced by the first k nodes
+static Graph first_nodes_subgraph(const Graph& g, int k) {
+    Graph sub(k);
+    for (Node v=0; v<k; ++v) {
+        const set<Node>& neighbors = g.getNeighbors(v);
+        for (auto u = neighbors.begin(); u != neighbors.end() && *u < k; ++u) {
+            sub.addEdge(*u, v);
+        }
+    }
+    return sub;
+}
+
+// The DBPedia graphs, and the first 12 nodes of the easy random graphs
+static bool read_graphs(vector<Graph>& graphs) {
+    string filename;
+    DirectoryIterator di(DATASET_DIR_BASE+DATASET_DIR_DEADEASY+"DBPedia");
+    while (di.next_file(filename)) {
+        graphs.push_back(GraphReader::read(filename));
+        ASSERT(!GraphReader::last_read_failed());
+    }
+    for (string p : {"30", "50", "70"}) {
+        Graph g = GraphReader::read(DATASET_DIR_BASE+DATASET_DIR_EASY+
+                                    "Probability"+p+"percent"+SLASH+"20.csv");
+        ASSERT(!GraphReader::last_read_failed());
+        graphs.push_back(first_nodes_subgraph(g, 12));
+    }
+    return true;
+}
+
+static TriangulationEvaluator* new_evaluator(const Graph& g, bool fill,
+        const NodeSetSet& incs = NodeSetSet(), const NodeSetSet& excs = NodeSetSet()) {
+    if (fill) {
+        return new TriangFillEvaluator(g, incs, excs);
+    }
+    return new TriangTreeWidthEvaluator(g, incs, excs);
+}
+
+// A triangulation is identified by its fill edges
+typedef vector< set<Node> > FillEdges;
+
+// The graphs have far fewer minimal triangulations. Stops a faulty
+// enumeration that keeps returning triangulations.
+#define RANKEDTRIANGULATIONSTESTER_MAX_RESULTS (1000)
+
+RankedTriangulationsTester::RankedTriangulationsTester() :
+    TestInterface("Ranked Triangulations Tester")
+    #define X(test) , flag_##test(true)
+    RANKEDTRIANGULATIONSTESTER_TEST_TABLE
+    #undef X
+    {}
+
+RankedTriangulationsTester& RankedTriangulationsTester::go() {
+    if (graphs.empty() && !read_graphs(graphs)) {
+        failed = true;
+        return *this;
+    }
+    #define X(test) if (flag_##test) {DO_TEST(test);}
+    RANKEDTRIANGULATIONSTESTER_TEST_TABLE
+    #undef X
+    return *this;
+}
+
+// Setters / getters
+#define X(test) \
+RankedTriangulationsTester& RankedTriangulationsTester::set_##test() { flag_##test = true; return *this; } \
+RankedTriangulationsTester& RankedTriangulationsTester::unset_##test() { flag_##test = false; return *this; } \
+RankedTriangulationsTester& RankedTriangulationsTester::set_only_##test() { clear_all(); return set_##test(); }
+RANKEDTRIANGULATIONSTESTER_TEST_TABLE
+#undef X
+
+RankedTriangulationsTester& RankedTriangulationsTester::set_all() {
+    #define X(test) set_##test();
+    RANKEDTRIANGULATIONSTESTER_TEST_TABLE
+    #undef X
+    return *this;
+}
+RankedTriangulationsTester& RankedTriangulationsTester::clear_all() {
+    #define X(test) unset_##test();
+    RANKEDTRIANGULATIONSTESTER_TEST_TABLE
+    #undef X
+    return *this;
+}
+
+// Extending an evaluated evaluator (twice) re-evaluates only some of the
+// blocks, and should give the cost of an evaluator built with all of the
+// constraints.
+bool RankedTriangulationsTester::extended_evaluator_aux(bool fill) {
+    int legalResults = 0;
+    for (unsigned i=0; i<graphs.size(); ++i) {
+        const Graph& g = graphs[i];
+        OptimalMinimalTriangulator triangulator(g);
+        vector<MinimalSeparator> seps(triangulator.minSeps.begin(), triangulator.minSeps.end());
+        TriangulationEvaluator* root = new_evaluator(g, fill);
+        root->resizeByNumBlocks(triangulator.getNumBlocks());
+        float rootCost = triangulator.evaluate(root);
+        ASSERT_NEQ(rootCost, CONSTRAINT_VIOLATION);
+        for (int trial=0; trial<20; ++trial) {
+            NodeSetSet incs[2], excs[2], allIncs, allExcs;
+            for (int step=0; step<2; ++step) {
+                for (unsigned j=0; j<seps.size(); ++j) {
+                    if (allIncs.isMember(seps[j]) || allExcs.isMember(seps[j])) {
+                        continue;
+                    }
+                    if (rand() % 6 == 0) {
+                        incs[step].insert(seps[j]);
+                        allIncs.insert(seps[j]);
+                    } else if (rand() % 6 == 0) {
+                        excs[step].insert(seps[j]);
+                        allExcs.insert(seps[j]);
+                    }
+                }
+            }
+            TriangulationEvaluator* extended = root->extendEvaluator(incs[0], excs[0]);
+            triangulator.evaluate(extended);
+            TriangulationEvaluator* extendedTwice = extended->extendEvaluator(incs[1], excs[1]);
+            TriangulationEvaluator* fresh = new_evaluator(g, fill, allIncs, allExcs);
+            fresh->resizeByNumBlocks(triangulator.getNumBlocks());
+            float cost = triangulator.evaluate(extendedTwice);
+            float freshCost = triangulator.evaluate(fresh);
+            ASSERT_EQ(cost, freshCost);
+            ASSERT_GEQ(cost, rootCost);
+            if (cost != CONSTRAINT_VIOLATION) {
+                ++legalResults;
+            }
+            delete extended;
+            delete extendedTwice;
+            delete fresh;
+        }
+        delete root;
+    }
+    // Not all of the constraint sets should be violated
+    ASSERT_GREATER(legalResults, 0);
+    return true;
+}
+bool RankedTriangulationsTester::extended_evaluator_fill() {
+    return extended_evaluator_aux(true);
+}
+bool RankedTriangulationsTester::extended_evaluator_width() {
+    return extended_evaluator_aux(false);
+}
+
+bool RankedTriangulationsTester::ranked_costs_ascending() {
+    for (unsigned i=0; i<graphs.size(); ++i) {
+        const Graph& g = graphs[i];
+        for (bool fill : {true, false}) {
+            RankedTriangulationsEnumerator rte(g, new_evaluator(g, fill));
+            int lastCost = -1;
+            for (int count=0; rte.hasNext(); ++count) {
+                ASSERT_LESS(count, RANKEDTRIANGULATIONSTESTER_MAX_RESULTS);
+                ChordalGraph triangulation = rte.next();
+                int cost = fill ? triangulation.getFillIn(g) : triangulation.getTreeWidth();
+                ASSERT_LEQ(lastCost, cost);
+                lastCost = cost;
+            }
+        }
+    }
+    return true;
+}
+
+bool RankedTriangulationsTester::ranked_no_duplicates() {
+    for (unsigned i=0; i<graphs.size(); ++i) {
+        const Graph& g = graphs[i];
+        for (bool fill : {true, false}) {
+            RankedTriangulationsEnumerator rte(g, new_evaluator(g, fill));
+            set<FillEdges> found;
+            for (int count=0; rte.hasNext(); ++count) {
+                ASSERT_LESS(count, RANKEDTRIANGULATIONSTESTER_MAX_RESULTS);
+                FillEdges fillEdges = rte.next().getFillEdges(g);
+                ASSERT(found.insert(fillEdges).second);
+            }
+        }
+    }
+    return true;
+}
+
+// The costs of the triangulations the enumerator returns until hasNext()
+// is false. k is passed to setMaxResults (0 means no limit).
+static bool ranked_costs(const Graph& g, bool fill, int k, vector<int>& costs) {
+    RankedTriangulationsEnumerator rte(g, new_evaluator(g, fill));
+    rte.setMaxResults(k);
+    while (rte.hasNext()) {
+        ASSERT_LESS(int(costs.size()), RANKEDTRIANGULATIONSTESTER_MAX_RESULTS);
+        ChordalGraph triangulation = rte.next();
+        costs.push_back(fill ? triangulation.getFillIn(g) : triangulation.getTreeWidth());
+    }
+    return true;
+}
+
+// The ranked enumeration returns all of the minimal triangulations
+bool RankedTriangulationsTester::ranked_count() {
+    for (unsigned i=0; i<graphs.size(); ++i) {
+        const Graph& g = graphs[i];
+        set<FillEdges> expected;
+        MinimalTriangulationsEnumerator mte(g, NONE, UNIFORM, MCS_M);
+        while (mte.hasNext()) {
+            expected.insert(mte.next().getFillEdges(g));
+        }
+        for (bool fill : {true, false}) {
+            RankedTriangulationsEnumerator rte(g, new_evaluator(g, fill));
+            set<FillEdges> found;
+            int count = 0;
+            while (rte.hasNext()) {
+                ASSERT_LESS(count, RANKEDTRIANGULATIONSTESTER_MAX_RESULTS);
+                found.insert(rte.next().getFillEdges(g));
+                ++count;
+            }
+            ASSERT_EQ(count, int(expected.size()));
+            ASSERT(found == expected);
+        }
+    }
+    return true;
+}
+
+// Limiting the enumeration to the k best triangulations returns the first k
+// costs of the unbounded enumeration, and hasNext() is false after k results.
+bool RankedTriangulationsTester::ranked_top_k() {
+    for (unsigned i=0; i<graphs.size(); ++i) {
+        const Graph& g = graphs[i];
+        for (bool fill : {true, false}) {
+            vector<int> allCosts;
+            ASSERT(ranked_costs(g, fill, 0, allCosts));
+            for (int k=1; k<=5; ++k) {
+                vector<int> costs;
+                ASSERT(ranked_costs(g, fill, k, costs));
+                int expected = min(k, int(allCosts.size()));
+                ASSERT_EQ(int(costs.size()), expected);
+                ASSERT(costs == vector<int>(allCosts.begin(), allCosts.begin() + expected));
+            }
+        }
+    }
+    return true;
+}
+
+// The parallel enumeration returns the same triangulations in the same order
+bool RankedTriangulationsTester::ranked_parallel_order() {
+    for (unsigned i=0; i<graphs.size(); ++i) {
+        const Graph& g = graphs[i];
+        for (bool fill : {true, false}) {
+            RankedTriangulationsEnumerator sequential(g, new_evaluator(g, fill));
+            RankedTriangulationsEnumerator parallel(g, new_evaluator(g, fill));
+            parallel.enable_parallel();
+            for (int count=0; sequential.hasNext(); ++count) {
+                ASSERT_LESS(count, RANKEDTRIANGULATIONSTESTER_MAX_RESULTS);
+                ASSERT(parallel.hasNext());
+                ASSERT(sequential.next().getFillEdges(g) == parallel.next().getFillEdges(g));
+            }
+            ASSERT(!parallel.hasNext());
+        }
+    }
+    return true;
+}
+
+}
@@ -0,0 +1,46 @@
+#ifndef RANKEDTRIANGULATIONSTESTER_H_INCLUDED
+#define RANKEDTRIANGULATIONSTESTER_H_INCLUDED
+
+#include "Graph.h"
+#include "TestInterface.h"
+#include "TriangulationEvaluator.h"
+
+namespace tdenum {
+
+#define RANKEDTRIANGULATIONSTESTER_TEST_TABLE \
+    X(extended_evaluator_fill) \
+    X(extended_evaluator_width) \
+    X(ranked_costs_ascending) \
+    X(ranked_no_duplicates) \
+    X(ranked_count) \
+    X(ranked_top_k) \
+    X(ranked_parallel_order)
+
+class RankedTriangulationsTester : public TestInterface {
+private:
+
+    // Small graphs from the datasets
+    vector<Graph> graphs;
+
+    bool extended_evaluator_aux(bool fill);
+
+    #define X(test) bool flag_##test;
+    RANKEDTRIANGULATIONSTESTER_TEST_TABLE
+    #undef X
+    RankedTriangulationsTester& go();
+public:
+    RankedTriangulationsTester();
+    #define X(test) \
+    RankedTriangulationsTester& set_##test(); \
+    RankedTriangulationsTester& unset_##test(); \
+    RankedTriangulationsTester& set_only_##test(); \
+    bool test();
+    RANKEDTRIANGULATIONSTESTER_TEST_TABLE
+    #undef X
+    RankedTriangulationsTester& set_all();
+    RankedTriangulationsTester& clear_all();
+};
+
+}
+
+#endif // RANKEDTRIANGULATIONSTESTER_H_INCLUDED
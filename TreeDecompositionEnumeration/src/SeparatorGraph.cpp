@@ -3,21 +3,64 @@
 
 namespace tdenum {
 
+// Default number of component maps kept in the cache
+#define SEPARATOR_GRAPH_CACHE_CAPACITY (256)
+
 SeparatorGraph::SeparatorGraph(const Graph& g, SeparatorsScoringCriterion c) :
-		graph(g), nodesEnumerator(g, c), nodesGenerated(0) {}
+		graph(g), nodesEnumerator(g, c), nodesGenerated(0), allNodesGenerated(false),
+		cacheCapacity(SEPARATOR_GRAPH_CACHE_CAPACITY), useCrossingMatrix(false) {}
 
 bool SeparatorGraph::hasNextNode() {
-	return nodesEnumerator.hasNext();
+	if (!nodesEnumerator.hasNext()) {
+		allNodesGenerated = true;
+		return false;
+	}
+	return true;
 }
 
 MinimalSeparator SeparatorGraph::nextNode() {
 	nodesGenerated++;
-	return nodesEnumerator.next();
+	MinimalSeparator s = nodesEnumerator.next();
+	getID(s);
+	return s;
 }
 
-// check if the nodes of v are in different components of the graph obtained by removing u
-bool SeparatorGraph::hasEdge(const MinimalSeparator& s, const MinimalSeparator& t) {
-	vector<int> componentsMap = graph.getComponentsMap(s);
+int SeparatorGraph::getID(const MinimalSeparator& s) {
+	NodeSetSet::iterator it = separators.find(s);
+	if (it != separators.end()) {
+		return it - separators.begin();
+	}
+	separators.insert(s);
+	cachePositions.push_back(componentsCache.end());
+	return separators.size() - 1;
+}
+
+/*
+ * Returns the component map of the given separator, from the cache if it is
+ * there. Otherwise it is calculated and replaces the least recently used map.
+ */
+const vector<int>& SeparatorGraph::getComponentsMap(int separatorID) {
+	list<CachedComponents>::iterator it = cachePositions[separatorID];
+	if (it != componentsCache.end()) {
+		componentsCache.splice(componentsCache.begin(), componentsCache, it);
+		return it->componentsMap;
+	}
+	if (componentsCache.size() >= cacheCapacity && !componentsCache.empty()) {
+		cachePositions[componentsCache.back().separatorID] = componentsCache.end();
+		componentsCache.pop_back();
+	}
+	CachedComponents cached;
+	cached.separatorID = separatorID;
+	cached.componentsMap = graph.getComponentsMap(*(separators.begin() + separatorID));
+	componentsCache.push_front(cached);
+	// A capacity of 0 keeps just the current map
+	cachePositions[separatorID] = cacheCapacity > 0 ? componentsCache.begin() : componentsCache.end();
+	return componentsCache.front().componentsMap;
+}
+
+// check if the nodes of t are in different components of the graph obtained
+// by removing the nodes of s (given by its component map)
+static bool separatesNodes(const vector<int>& componentsMap, const MinimalSeparator& t) {
 	int componentContainingT = 0;
 	for (MinimalSeparator::const_iterator it = t.begin(); it != t.end(); ++it) {
 		int componentContainingCurrentNode = componentsMap[*it];
@@ -35,9 +78,63 @@ bool SeparatorGraph::hasEdge(const MinimalSeparator& s, const MinimalSeparator&
 	return false;
 }
 
+/*
+ * Calculates the crossing relation of all the separators generated. Crossing
+ * is symmetric, so each pair is checked once.
+ */
+void SeparatorGraph::calculateCrossingMatrix() {
+	int numSeparators = separators.size();
+	crossingMatrix.assign(numSeparators, DynamicNodeBitSet());
+	for (int i = 0; i < numSeparators; i++) {
+		vector<int> componentsMap = graph.getComponentsMap(*(separators.begin() + i));
+		for (int j = i + 1; j < numSeparators; j++) {
+			if (separatesNodes(componentsMap, *(separators.begin() + j))) {
+				crossingMatrix[i].insert(j);
+				crossingMatrix[j].insert(i);
+			}
+		}
+	}
+}
+
+bool SeparatorGraph::hasEdge(const MinimalSeparator& s, const MinimalSeparator& t) {
+	if (useCrossingMatrix && allNodesGenerated) {
+		if (crossingMatrix.empty() && !separators.empty()) {
+			calculateCrossingMatrix();
+		}
+		NodeSetSet::iterator sIt = separators.find(s);
+		NodeSetSet::iterator tIt = separators.find(t);
+		int sID = sIt - separators.begin();
+		int tID = tIt - separators.begin();
+		if (sIt != separators.end() && tIt != separators.end()
+				&& sID < (int)crossingMatrix.size() && tID < (int)crossingMatrix.size()) {
+			return crossingMatrix[sID].contains(tID);
+		}
+	}
+	return separatesNodes(getComponentsMap(getID(s)), t);
+}
+
 int SeparatorGraph::getNumberOfNodesGenerated() {
 	return nodesGenerated;
 }
 
-} /* namespace tdenum */
+SeparatorGraph& SeparatorGraph::setCacheCapacity(unsigned int capacity) {
+	cacheCapacity = capacity;
+	while (componentsCache.size() > cacheCapacity) {
+		cachePositions[componentsCache.back().separatorID] = componentsCache.end();
+		componentsCache.pop_back();
+	}
+	return *this;
+}
+
+SeparatorGraph& SeparatorGraph::enable_crossing_matrix() {
+	useCrossingMatrix = true;
+	return *this;
+}
 
+SeparatorGraph& SeparatorGraph::suppress_crossing_matrix() {
+	useCrossingMatrix = false;
+	crossingMatrix.clear();
+	return *this;
+}
+
+} /* namespace tdenum */
@@ -2,6 +2,8 @@
 #define SEPARATORGRAPH_H_
 #include "MinimalSeparatorsEnumerator.h"
 #include "SuccinctGraphRepresentation.h"
+#include "DataStructures.h"
+#include <list>
 
 namespace tdenum {
 
@@ -11,9 +13,31 @@ namespace tdenum {
  * An edge appears between two minimal separators if they are crossing.
  */
 class SeparatorGraph : public SuccinctGraphRepresentation<MinimalSeparator> {
+	// A component map (see Graph::getComponentsMap) of a separator
+	struct CachedComponents {
+		int separatorID;
+		vector<int> componentsMap;
+	};
 	Graph graph;
 	MinimalSeparatorsEnumerator nodesEnumerator;
 	int nodesGenerated;
+	bool allNodesGenerated;
+	// The separators seen so far. The id of a separator is its index.
+	NodeSetSet separators;
+	// The recently used component maps, most recent first, and the position
+	// of each separator's map in the list (or its end).
+	list<CachedComponents> componentsCache;
+	vector<list<CachedComponents>::iterator> cachePositions;
+	unsigned int cacheCapacity;
+	// If enabled, once all the separators were generated the crossing
+	// relation is calculated over all of them: row i holds the ids of the
+	// separators crossing separator i.
+	bool useCrossingMatrix;
+	vector<DynamicNodeBitSet> crossingMatrix;
+
+	int getID(const MinimalSeparator& s);
+	const vector<int>& getComponentsMap(int separatorID);
+	void calculateCrossingMatrix();
 public:
 	// Initialization
 	SeparatorGraph(const Graph& g, SeparatorsScoringCriterion c);
@@ -21,10 +45,17 @@ public:
 	virtual bool hasNextNode();
 	// Returns another minimal separator
 	virtual MinimalSeparator nextNode();
-	// Checks whether the minimal separators are crossing
+	// Checks whether the minimal separators are crossing. Not safe for
+	// concurrent calls, as it updates the caches.
 	virtual bool hasEdge(const MinimalSeparator& u, const MinimalSeparator& v);
 	// Returns how many nodes were already generated
 	int getNumberOfNodesGenerated();
+	// Sets the number of component maps kept between hasEdge() calls
+	SeparatorGraph& setCacheCapacity(unsigned int capacity);
+	// Once all the separators were generated, answers hasEdge() from a
+	// precalculated crossing matrix (quadratic in the number of separators)
+	SeparatorGraph& enable_crossing_matrix();
+	SeparatorGraph& suppress_crossing_matrix();
 };
 
 } /* namespace tdenum */
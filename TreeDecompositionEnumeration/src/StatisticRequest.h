@@ -1,6 +1,7 @@
 #ifndef STATISTICREQUEST_H_INCLUDED
 #define STATISTICREQUEST_H_INCLUDED
 
+#include <limits>
 #include <ostream>
 #include <set>
 #include "PMCAlg.h"
@@ -84,8 +85,8 @@ private:
     STATISTICREQUEST_FLAG_TABLE
     #undef X
 
-    // Time limits
-    #define X(calculation) time_t time_limit_##calculation;
+    // Time limits (in seconds)
+    #define X(calculation) double time_limit_##calculation;
     STATISTICREQUEST_TIME_LIMITS
     #undef X
 
@@ -111,7 +112,7 @@ private:
 
 public:
 
-    static const time_t invalid_time_limit = UTILS__MAX_TIME;
+    static constexpr double invalid_time_limit = std::numeric_limits<double>::max();
     static const long invalid_count_limit = UTILS__MAX_LONG;
 
     StatisticRequest();
@@ -152,11 +153,11 @@ public:
     StatisticRequest& unset_all_trng_calculations();
 
     // Set/unset/get limits
-    // Time limits:
+    // Time limits (in seconds, may be fractional):
     #define X(calculation) \
-        StatisticRequest& set_time_limit_##calculation(time_t); \
+        StatisticRequest& set_time_limit_##calculation(double); \
         StatisticRequest& unset_time_limit_##calculation(); \
-        time_t get_time_limit_##calculation(bool suppress_error = false) const; \
+        double get_time_limit_##calculation(bool suppress_error = false) const; \
         bool test_time_limit_##calculation() const;
     STATISTICREQUEST_TIME_LIMITS
     #undef X
@@ -176,6 +176,52 @@ namespace tdenum {
 
 	}
 
+	SubGraph::SubGraph(const Graph& mainGraph, const NodeSet& nodeSetInMainGraph) :
+		Graph(nodeSetInMainGraph.size()), mainGraph(mainGraph),
+		nodeMapToMainGraph(nodeSetInMainGraph) {
+
+		vector<int> mainNodesInSub(mainGraph.getNumberOfNodes(), -1);
+		for (unsigned int nodeInSub = 0; nodeInSub < nodeSetInMainGraph.size(); nodeInSub++) {
+			mainNodesInSub[nodeSetInMainGraph[nodeInSub]] = nodeInSub;
+			nodeMapFromMainGraph[nodeSetInMainGraph[nodeInSub]] = nodeInSub;
+		}
+
+		// Add each edge once, from its later endpoint
+		for (unsigned int nodeInSub = 0; nodeInSub < nodeSetInMainGraph.size(); nodeInSub++) {
+			Node nodeInMain = nodeSetInMainGraph[nodeInSub];
+			mainNodesInSub[nodeInMain] = -1;
+			for (Node neighborInMain : mainGraph.getNeighbors(nodeInMain)) {
+				if (mainNodesInSub[neighborInMain] >= 0) {
+					addEdge(nodeInSub, mainNodesInSub[neighborInMain]);
+				}
+			}
+		}
+	}
+
+	SubGraph::SubGraph(const SubGraph& prefixGraph, Node nodeInMainGraph) :
+		Graph(prefixGraph.getNumberOfNodes() + 1), mainGraph(prefixGraph.mainGraph),
+		nodeMapToMainGraph(prefixGraph.nodeMapToMainGraph),
+		nodeMapFromMainGraph(prefixGraph.nodeMapFromMainGraph) {
+
+		Node newNode = prefixGraph.getNumberOfNodes();
+		nodeMapToMainGraph.push_back(nodeInMainGraph);
+		nodeMapFromMainGraph[nodeInMainGraph] = newNode;
+
+		for (Node u = 0; u < newNode; u++) {
+			for (Node v : prefixGraph.getNeighbors(u)) {
+				if (u < v) {
+					addEdge(u, v);
+				}
+			}
+		}
+		for (Node neighborInMain : mainGraph.getNeighbors(nodeInMainGraph)) {
+			auto it = nodeMapFromMainGraph.find(neighborInMain);
+			if (it != nodeMapFromMainGraph.end() && it->second != newNode) {
+				addEdge(it->second, newNode);
+			}
+		}
+	}
+
 	SubGraph::SubGraph(const SubGraph& fatherGraph, NodeSet nodeSetInFatherGraph,
 		const set<MinimalSeparator>& seps) :
 		SubGraph(fatherGraph, nodeSetInFatherGraph) {
@@ -216,7 +262,7 @@ namespace tdenum {
 				mainS.insert(nodeMapToMainGraph.at(*n));
 			for (auto n = subBlocks[i]->C.begin(); n != subBlocks[i]->C.end(); n++)
 				mainC.insert(nodeMapToMainGraph.at(*n));
-			mainBlocks[i] = BlockPtr(new Block(mainS.produce(), mainC.produce(),mainGraph.getNumberOfNodes()));
+			mainBlocks[i] = BlockPtr(new Block(mainS.produce(), mainC.produce()));
 		}
 		return mainBlocks;
 	}
@@ -27,6 +27,14 @@ namespace tdenum {
 
 		SubGraph(const SubGraph& fatherGraph, NodeSet nodeSetInFatherGraph);
 
+		// The subgraph of mainGraph induced by the given nodes, without
+		// copying mainGraph first.
+		SubGraph(const Graph& mainGraph, const NodeSet& nodeSetInMainGraph);
+
+		// The subgraph induced by the nodes of prefixGraph and the given
+		// node of the main graph, which becomes the last node.
+		SubGraph(const SubGraph& prefixGraph, Node nodeInMainGraph);
+
 		// first graph init
 		SubGraph(const Graph& mainGraph);
 
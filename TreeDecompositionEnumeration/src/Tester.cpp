@@ -63,12 +63,15 @@ int main(int argc, char** argv) {
     // Go
     Tester().clear_all()
             .set_UtilsTester()
+            .set_DataStructuresTester()
             .set_GraphTester()
             .set_GraphStatsTester()
             .set_GraphProducerTester()
             .set_PMCEnumeratorTester()
             .set_StatisticRequestTester()
             .set_PMCRacerTester()
+            .set_RankedTriangulationsTester()
+            .set_MinimalTriangulationsTester()
             .set_DatasetTester()
             .start();
     return 0;
@@ -2,11 +2,14 @@
 #define TESTER_H_INCLUDED
 
 #include "DatasetTester.h"
+#include "DataStructuresTester.h"
 #include "GraphProducerTester.h"
 #include "GraphStatsTester.h"
 #include "GraphTester.h"
+#include "MinimalTriangulationsTester.h"
 #include "PMCEnumeratorTester.h"
 #include "PMCRacerTester.h"
+#include "RankedTriangulationsTester.h"
 #include "StatisticRequestTester.h"
 #include "TestInterface.h"
 #include "UtilsTester.h"
@@ -23,12 +26,15 @@ namespace tdenum {
  */
 #define TESTER_TEST_TABLE \
     X(UtilsTester) \
+    X(DataStructuresTester) \
     X(GraphTester) \
     X(GraphStatsTester) \
     X(GraphProducerTester) \
     X(PMCEnumeratorTester) \
     X(StatisticRequestTester) \
     X(PMCRacerTester) \
+    X(RankedTriangulationsTester) \
+    X(MinimalTriangulationsTester) \
     X(DatasetTester)
 
 // Static (compile-time) sanity check
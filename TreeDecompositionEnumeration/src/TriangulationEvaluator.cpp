@@ -13,6 +13,98 @@ namespace tdenum {
 			return;
 		blockByID.resize(numBlocks, NULL);
 		blockCostByID.resize(numBlocks, maxValue());
+		blockBestPMCByID.resize(numBlocks, NULL);
+	}
+
+	int ConstraintIndex::getID(const NodeSet& c) {
+		int id = findID(c);
+		if (id >= 0)
+			return id;
+		consts.insert(c);
+		constNodes.push_back(DynamicNodeBitSet(c));
+		return consts.size() - 1;
+	}
+
+	int ConstraintIndex::findID(const NodeSet& c) const {
+		auto it = consts.find(c);
+		if (it == consts.end())
+			return -1;
+		return it - consts.begin();
+	}
+
+	void TriangulationEvaluator::addConstraints(const NodeSetSet& incConsts,
+			const NodeSetSet& excConsts) {
+		for (auto c = incConsts.begin(); c != incConsts.end(); c++) {
+			int id = constIndex->getID(*c);
+			if (!inclusionIDs.contains(id)) {
+				inclusionIDs.insert(id);
+				inclusionList.push_back(id);
+			}
+		}
+		for (auto c = excConsts.begin(); c != excConsts.end(); c++) {
+			int id = constIndex->getID(*c);
+			if (!exclusionIDs.contains(id)) {
+				exclusionIDs.insert(id);
+				exclusionList.push_back(id);
+			}
+		}
+	}
+
+	bool TriangulationEvaluator::isInclusionConst(const NodeSet& c) const {
+		int id = constIndex->findID(c);
+		return id >= 0 && inclusionIDs.contains(id);
+	}
+
+	bool TriangulationEvaluator::isExclusionConst(const NodeSet& c) const {
+		int id = constIndex->findID(c);
+		return id >= 0 && exclusionIDs.contains(id);
+	}
+
+	void TriangulationEvaluator::extendFrom(const TriangulationEvaluator& parent,
+			const NodeSetSet& newIncs, const NodeSetSet& newExcs) {
+		constIndex = parent.constIndex;
+		inclusionIDs = parent.inclusionIDs;
+		exclusionIDs = parent.exclusionIDs;
+		inclusionList = parent.inclusionList;
+		exclusionList = parent.exclusionList;
+		addConstraints(newIncs, newExcs);
+
+		if (!parent.evaluatedAllBlocks) {
+			resizeByNumBlocks(parent.blockByID.size());
+			return;
+		}
+		blockByID = parent.blockByID;
+		blockCostByID = parent.blockCostByID;
+		blockBestPMCByID = parent.blockBestPMCByID;
+		extendsEvaluated = true;
+		// Constraints the parent already has don't change any block
+		newConstIDs.assign(inclusionList.begin() + parent.inclusionList.size(),
+			inclusionList.end());
+		newConstIDs.insert(newConstIDs.end(),
+			exclusionList.begin() + parent.exclusionList.size(), exclusionList.end());
+	}
+
+	bool TriangulationEvaluator::needsBlockUpdate(const Block& B) const {
+		if (!extendsEvaluated)
+			return true;
+		// A constraint only affects the blocks including it (see
+		// curBlockUpholdsConstraints), and the sub blocks of a block are
+		// included in it. So a block including none of the new constraints
+		// keeps its result.
+		for (int id : newConstIDs)
+			if (constIndex->getNodes(id).isSubsetOf(B.fullNodes))
+				return true;
+		return false;
+	}
+
+	void TriangulationEvaluator::keepBlock(const Block& B) {
+		if (curBlock != NULL) {
+			finishedCurBlock();
+			curBlockID++;
+		}
+		curBlock = &B;
+		curBlockBestPMC = blockBestPMCByID[curBlockID];
+		curBlockBestCost = blockCostByID[curBlockID];
 	}
 
 	void TriangulationEvaluator::startNewBlock(const Block& B) {
@@ -23,14 +115,28 @@ namespace tdenum {
 		curBlock = &B;
 		curBlockBestPMC = NULL;
 		curBlockBestCost = maxValue();
+
+		// Find the constraints that apply to this block
+		curBlockSExcluded = isExclusionConst(B.S);
+		curBlockInclusions.clear();
+		curBlockExclusions.clear();
+		for (int id : inclusionList)
+			if (constIndex->getNodes(id).isSubsetOf(B.fullNodes))
+				curBlockInclusions.push_back(id);
+		for (int id : exclusionList)
+			if (constIndex->getNodes(id).isSubsetOf(B.fullNodes))
+				curBlockExclusions.push_back(id);
 	}
 	
 	void TriangulationEvaluator::finishedCurBlock() {
 		blockByID[curBlockID] = curBlock;
 		blockCostByID[curBlockID] = curBlockBestCost;
+		blockBestPMCByID[curBlockID] = curBlockBestPMC;
+		if (curBlockID + 1 == (int)blockByID.size())
+			evaluatedAllBlocks = true;
 	}
 
-	void TriangulationEvaluator::evalSaturatePMC(const NodeSet& pmc, const vector<int>& pmcBlockIDs) {
+	void TriangulationEvaluator::evalSaturatePMC(const NodeSet& pmc, const BlockIDRange& pmcBlockIDs) {
 		float curCost = curBlockUpholdsConstraints(pmc, pmcBlockIDs)? 
 			costSaturatePMC(pmc, pmcBlockIDs) : CONSTRAINT_VIOLATION;
 		
@@ -41,10 +147,10 @@ namespace tdenum {
 		}
 	}
 
-	bool TriangulationEvaluator::curBlockUpholdsConstraints(const NodeSet& pmc, const vector<int>& pmcBlockIDs) {
+	bool TriangulationEvaluator::curBlockUpholdsConstraints(const NodeSet& pmc, const BlockIDRange& pmcBlockIDs) {
 		// If current blocks S is in the exclusion list, 
 		// this block can't be part of a legal triangulation
-		if (exclusionConsts.isMember(curBlock->S))
+		if (curBlockSExcluded)
 			return false;
 
 		// Iterate once over PMCs sub blocks
@@ -54,15 +160,18 @@ namespace tdenum {
 			if (blockCostByID[*bID] == CONSTRAINT_VIOLATION)
 				return false;
 
-		// Check inclusion constraints are upheld
-		for (auto constraint = inclusionConsts.begin();
-			constraint != inclusionConsts.end(); constraint++) {
-			// If constraint is not contained in this block it is irrelevant
-			if (!(curBlock->includesNodes(*constraint)))
-				continue;
+		// Constraints not contained in this block are irrelevant
+		if (curBlockInclusions.empty() && curBlockExclusions.empty())
+			return true;
+		curPMCNodes.clear();
+		for (auto v = pmc.begin(); v != pmc.end(); v++)
+			curPMCNodes.insert(*v);
 
+		// Check inclusion constraints are upheld
+		for (int id : curBlockInclusions) {
+			const DynamicNodeBitSet& constraint = constIndex->getNodes(id);
 			// If constraint is contained in the current PMC
-			if (includes(pmc.begin(), pmc.end(), constraint->begin(), constraint->end()))
+			if (constraint.isSubsetOf(curPMCNodes))
 				// It is upheld by filling in this PMC
 				// (saturating a minimal separator of G makes it a minimal separator of H)
 				continue;
@@ -71,7 +180,7 @@ namespace tdenum {
 			bool containedInBlock = false;
 			// Check if the constraint is contained in some block
 			for (auto bID = pmcBlockIDs.begin(); bID != pmcBlockIDs.end(); bID++)
-				if (blockByID[*bID]->includesNodes(*constraint)) {
+				if (constraint.isSubsetOf(blockByID[*bID]->fullNodes)) {
 					containedInBlock = true;
 					break;
 				}
@@ -83,10 +192,9 @@ namespace tdenum {
 		}
 			
 		// Check exclusion constraints are upheld
-		for (auto constraint = exclusionConsts.begin();
-			constraint != exclusionConsts.end(); constraint++) {
+		for (int id : curBlockExclusions) {
 			// If constraint is contained in the current PMC
-			if (includes(pmc.begin(), pmc.end(), constraint->begin(), constraint->end()))
+			if (constIndex->getNodes(id).isSubsetOf(curPMCNodes))
 				// It is violated by filling in this PMC
 				// (saturating a minimal separator of G makes it a minimal separator of H)
 				return false;
@@ -104,8 +212,8 @@ namespace tdenum {
 	}
 
 	TriangulationEvaluator* TriangFillEvaluator::extendEvaluator(const NodeSetSet& newIncs, const NodeSetSet& newExcs) {
-		TriangulationEvaluator* extended = new TriangFillEvaluator(originalGraph, inclusionConsts.unify(newIncs), exclusionConsts.unify(newExcs));
-		extended->resizeByNumBlocks(blockByID.size());
+		TriangFillEvaluator* extended = new TriangFillEvaluator(originalGraph);
+		extended->extendFrom(*this, newIncs, newExcs);
 		return extended;
 	}
 
@@ -114,7 +222,7 @@ namespace tdenum {
 		curSFill = calcNodeSetFill(B.S);
 	}
 
-	float TriangFillEvaluator::costSaturatePMC(const NodeSet& pmc, const vector<int>& pmcBlockIDs) {
+	float TriangFillEvaluator::costSaturatePMC(const NodeSet& pmc, const BlockIDRange& pmcBlockIDs) {
 		// Calculate the fill of the block triangulation with this pmc
 		// without filling in S (like in Bouchitte and Todinca paper)
 		float curCost = calcNodeSetFill(pmc) - curSFill;
@@ -143,12 +251,12 @@ namespace tdenum {
 	}
 
 	TriangulationEvaluator* TriangTreeWidthEvaluator::extendEvaluator(const NodeSetSet& newIncs, const NodeSetSet& newExcs) {
-		TriangulationEvaluator* extended = new TriangTreeWidthEvaluator(originalGraph, inclusionConsts.unify(newIncs), exclusionConsts.unify(newExcs));
-		extended->resizeByNumBlocks(blockByID.size());
+		TriangTreeWidthEvaluator* extended = new TriangTreeWidthEvaluator(originalGraph);
+		extended->extendFrom(*this, newIncs, newExcs);
 		return extended;
 	}
 
-	float TriangTreeWidthEvaluator::costSaturatePMC(const NodeSet& pmc, const vector<int>& pmcBlockIDs) {
+	float TriangTreeWidthEvaluator::costSaturatePMC(const NodeSet& pmc, const BlockIDRange& pmcBlockIDs) {
 		// Calculate tree width of block triangulation with this pmc
 		float curCost = pmc.size() - 1;
 		for (auto i = pmcBlockIDs.begin(); i != pmcBlockIDs.end(); i++)
@@ -3,12 +3,32 @@
 #include "Graph.h"
 #include "SubGraph.h"
 #include "DataStructures.h"
+#include <memory>
 #include <set>
 
 #define HUGE_VALF 1e300
-#define CONSTRAINT_VIOLATION HUGE_VALF
+// The costs are floats, so the violation is compared as a float as well
+#define CONSTRAINT_VIOLATION ((float)HUGE_VALF)
 
 namespace tdenum {
+	/**
+	* Numbers the constraints of an evaluator and of the evaluators extending
+	* it, so that a set of constraints is a bitset over their ids.
+	* Constraints are added only when an evaluator is created (not while
+	* evaluating), so the evaluators may be used concurrently.
+	*/
+	class ConstraintIndex {
+		NodeSetSet consts;
+		vector<DynamicNodeBitSet> constNodes;
+	public:
+		// Returns the id of the constraint, adding it if it's new
+		int getID(const NodeSet&);
+		// Returns -1 if the node set isn't a constraint
+		int findID(const NodeSet&) const;
+		const DynamicNodeBitSet& getNodes(int id) const { return constNodes[id]; }
+	};
+	typedef shared_ptr<ConstraintIndex> ConstraintIndexPtr;
+
 	/**
 	* TODO - write documentation
 	*/
@@ -18,35 +38,67 @@ namespace tdenum {
 
 		vector<const Block*> blockByID;
 		vector<float> blockCostByID;
+		vector<const NodeSet*> blockBestPMCByID;
+		// Set once every block was evaluated
+		bool evaluatedAllBlocks;
+		// If this evaluator extends an evaluated one, the ids of the
+		// constraints it adds. Only blocks including one of them need to be
+		// recalculated.
+		bool extendsEvaluated;
+		vector<int> newConstIDs;
 
 		int curBlockID;
 		const Block* curBlock;
 		const NodeSet* curBlockBestPMC;
 		float curBlockBestCost;
 
-		const NodeSetSet inclusionConsts;
-		const NodeSetSet exclusionConsts;
-
-		bool curBlockUpholdsConstraints(const NodeSet&, const vector<int>&);
+		// The constraints, as sets of ids (shared with the evaluators
+		// extending this one), and as lists of ids
+		ConstraintIndexPtr constIndex;
+		DynamicNodeBitSet inclusionIDs;
+		DynamicNodeBitSet exclusionIDs;
+		vector<int> inclusionList;
+		vector<int> exclusionList;
+
+		// The constraints that apply to the current block: a constraint
+		// not included in the block can't be violated by its PMCs.
+		bool curBlockSExcluded;
+		vector<int> curBlockInclusions;
+		vector<int> curBlockExclusions;
+		DynamicNodeBitSet curPMCNodes;
+
+		void addConstraints(const NodeSetSet& incConsts, const NodeSetSet& excConsts);
+		bool curBlockUpholdsConstraints(const NodeSet&, const BlockIDRange&);
+
+		// Sets this evaluator to the given one with the given constraints
+		// added. If the given evaluator is evaluated, starts from its block
+		// results.
+		void extendFrom(const TriangulationEvaluator& parent,
+			const NodeSetSet& newIncs, const NodeSetSet& newExcs);
 
 	public:
 		TriangulationEvaluator(const Graph& G) :
-			originalGraph(G), blockByID(), blockCostByID(),
+			originalGraph(G), blockByID(), blockCostByID(), blockBestPMCByID(),
+			evaluatedAllBlocks(false), extendsEvaluated(false), newConstIDs(),
 			curBlockID(0), curBlock(NULL), curBlockBestPMC(NULL), 
-			inclusionConsts(), exclusionConsts()
+			constIndex(new ConstraintIndex()), curBlockSExcluded(false)
 			{ curBlockBestCost = maxValue(); }
 
 		TriangulationEvaluator(const Graph& G, const NodeSetSet& incConsts, const NodeSetSet& excConsts) :
-			originalGraph(G), blockByID(), blockCostByID(), 
+			originalGraph(G), blockByID(), blockCostByID(), blockBestPMCByID(),
+			evaluatedAllBlocks(false), extendsEvaluated(false), newConstIDs(),
 			curBlockID(0), curBlock(NULL), curBlockBestPMC(NULL) ,
-			inclusionConsts(incConsts), exclusionConsts(excConsts) { curBlockBestCost = maxValue(); }
+			constIndex(new ConstraintIndex()), curBlockSExcluded(false) {
+			curBlockBestCost = maxValue();
+			addConstraints(incConsts, excConsts);
+		}
 
-		~TriangulationEvaluator();
+		virtual ~TriangulationEvaluator();
 		
 		virtual TriangulationEvaluator* extendEvaluator(const NodeSetSet&, const NodeSetSet&) = 0;
 
-		const NodeSetSet& getInclusionConsts() { return inclusionConsts; }
-		const NodeSetSet& getExclusionConsts() { return exclusionConsts; }
+		bool isInclusionConst(const NodeSet&) const;
+		bool isExclusionConst(const NodeSet&) const;
 
 		virtual void resizeByNumBlocks(int);
 
@@ -54,11 +106,17 @@ namespace tdenum {
 		virtual void startNewBlock(const Block& B);
 		virtual void startNewBlock(const Block& B, const SubGraph& GinducedB) { startNewBlock(B); }
 
-		virtual void evalSaturatePMC(const NodeSet& pmc, const vector<int>& pmcBlockIDs);
+		// True if the next block has to be evaluated. Otherwise its result
+		// is the one of the evaluator this one extends, and keepBlock(B)
+		// should be called instead of startNewBlock(B).
+		bool needsBlockUpdate(const Block& B) const;
+		void keepBlock(const Block& B);
+
+		virtual void evalSaturatePMC(const NodeSet& pmc, const BlockIDRange& pmcBlockIDs);
 
 		virtual const NodeSet* getBestPMC() { return curBlockBestPMC; }
 		
-		virtual float costSaturatePMC(const NodeSet& pmc, const vector<int>& pmcBlockIDs) = 0;
+		virtual float costSaturatePMC(const NodeSet& pmc, const BlockIDRange& pmcBlockIDs) = 0;
 		virtual float maxValue() { return HUGE_VALF; };
 		virtual float getOptimalCost(int) = 0;
 	};
@@ -77,7 +135,7 @@ namespace tdenum {
 		TriangulationEvaluator* extendEvaluator(const NodeSetSet&, const NodeSetSet&);
 
 		void startNewBlock(const Block& B);
-		float costSaturatePMC(const NodeSet& pmc, const vector<int>& pmcBlockIDs);
+		float costSaturatePMC(const NodeSet& pmc, const BlockIDRange& pmcBlockIDs);
 		float maxValue() { 
 			return float(originalGraph.getNumberOfNodes() * (originalGraph.getNumberOfNodes() - 1)/2); 
 		}
@@ -93,7 +151,7 @@ namespace tdenum {
 
 		TriangulationEvaluator* extendEvaluator(const NodeSetSet&, const NodeSetSet&);
 
-		float costSaturatePMC(const NodeSet& pmc, const vector<int>& pmcBlockIDs);
+		float costSaturatePMC(const NodeSet& pmc, const BlockIDRange& pmcBlockIDs);
 		float maxValue() { return float(originalGraph.getNumberOfNodes() - 1); }
 
 		float getOptimalCost(int);
@@ -2,12 +2,15 @@
 #define UTILS_H_INCLUDED
 
 #include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <fstream>
 #include <iomanip>
 #include <iostream>
 #include <iterator>
 #include <limits>
 #include <map>
+#include <memory>
 #include <set>
 #include <sstream>
 #include <string>
@@ -90,6 +93,96 @@ void utils__insert_critical(const V& val, T& container) {
     }
 }
 
+// A boolean that may be read and written by several threads at once.
+// Unlike std::atomic<bool> it can be copied (the current value is copied), so
+// it can be a member of assignable classes.
+class AtomicFlag {
+    std::atomic<bool> value;
+public:
+    AtomicFlag(bool v = false) : value(v) {}
+    AtomicFlag(const AtomicFlag& other) : value(other.get()) {}
+    AtomicFlag& operator=(const AtomicFlag& other) { set(other.get()); return *this; }
+    AtomicFlag& operator=(bool v) { set(v); return *this; }
+    operator bool() const { return get(); }
+    bool get() const { return value.load(std::memory_order_relaxed); }
+    void set(bool v) { value.store(v, std::memory_order_relaxed); }
+};
+
+// A flag shared by all of its copies, used to stop long calculations from
+// outside. The caller keeps one copy and hands others to the enumerators
+// doing the work; after cancel() is called on any copy, they stop as soon as
+// they can, keeping whatever they found so far. A token can't be reset.
+class CancellationToken {
+    std::shared_ptr< std::atomic<bool> > flag;
+public:
+    CancellationToken() : flag(std::make_shared< std::atomic<bool> >(false)) {}
+    void cancel() const { flag->store(true, std::memory_order_relaxed); }
+    bool is_cancelled() const { return flag->load(std::memory_order_relaxed); }
+};
+
+// A time limit (in seconds, fractions allowed) on a monotonic clock, which
+// may also be cancelled, directly or through a watched CancellationToken.
+// A limit of 0 (or less) never expires by itself.
+// expired() only reads the clock once every DEADLINE_CHECK_STRIDE calls made
+// by the same thread, so inner loops may call it freely; expired_now() always
+// reads it. Once expired, a deadline stays expired.
+// Several threads may check (or cancel) the same deadline.
+#define DEADLINE_CHECK_STRIDE (64)
+class Deadline {
+    typedef std::chrono::steady_clock Clock;
+    Clock::time_point start;
+    Clock::time_point end;
+    bool bounded;
+    mutable AtomicFlag passed;
+    CancellationToken token;
+public:
+    explicit Deadline(double seconds = 0) { reset(seconds); }
+    // Restarts the clock with the given limit (the watched token is kept)
+    void reset(double seconds = 0) {
+        start = Clock::now();
+        passed = false;
+        set_limit(seconds);
+    }
+    // Changes the limit (counted from the last reset)
+    void set_limit(double seconds) {
+        bounded = (seconds > 0);
+        end = start + std::chrono::duration_cast<Clock::duration>(
+                          std::chrono::duration<double>(bounded ? seconds : 0));
+    }
+    // As set_limit, but for limits the user asked for explicitly: a limit of
+    // 0 (or less) has already passed, instead of meaning no limit.
+    void set_strict_limit(double seconds) {
+        set_limit(seconds);
+        if (!bounded) {
+            passed = true;
+        }
+    }
+    void cancel() { passed = true; }
+    // Expires once the token is cancelled
+    void watch(const CancellationToken& t) { token = t; }
+    bool is_bounded() const { return bounded; }
+    bool expired() const {
+        static thread_local unsigned calls = 0;
+        if (passed || token.is_cancelled()) {
+            return true;
+        }
+        if (!bounded || ++calls % DEADLINE_CHECK_STRIDE != 0) {
+            return false;
+        }
+        return expired_now();
+    }
+    bool expired_now() const {
+        if (!passed && (token.is_cancelled() || (bounded && Clock::now() >= end))) {
+            passed = true;
+        }
+        return passed;
+    }
+    // Seconds since the last reset
+    double elapsed() const {
+        return std::chrono::duration<double>(Clock::now() - start).count();
+    }
+};
+
 // Sleep for x milliseconds.
 void utils__sleep_msecs(int);
 
@@ -330,6 +330,55 @@ bool UtilsTester::time_functions() const {
 
     return true;
 }
+bool UtilsTester::deadline() const {
+    // No limit
+    Deadline unbounded;
+    ASSERT(!unbounded.is_bounded());
+    for (int i=0; i<10*DEADLINE_CHECK_STRIDE; ++i) {
+        ASSERT(!unbounded.expired());
+    }
+    ASSERT(!unbounded.expired_now());
+    unbounded.cancel();
+    ASSERT(unbounded.expired());
+    ASSERT(unbounded.expired_now());
+
+    // Sub-second limit
+    Deadline d(0.05);
+    ASSERT(d.is_bounded());
+    ASSERT(!d.expired_now());
+    utils__sleep_msecs(100);
+    ASSERT_GEQ(d.elapsed(), 0.05);
+    ASSERT(d.expired_now());
+    ASSERT(d.expired());    // Stays expired
+    d.reset(10);
+    ASSERT(!d.expired_now());
+    d.set_limit(0.01);
+    utils__sleep_msecs(20);
+    bool expired = false;
+    for (int i=0; i<DEADLINE_CHECK_STRIDE && !expired; ++i) {
+        expired = d.expired();
+    }
+    ASSERT(expired);
+
+    // A strict limit of 0 has already passed
+    Deadline z;
+    z.set_strict_limit(0);
+    ASSERT(z.expired());
+    ASSERT(z.expired_now());
+    z.reset();
+    ASSERT(!z.expired_now());
+    z.set_strict_limit(10);
+    ASSERT(z.is_bounded());
+    ASSERT(!z.expired_now());
+
+    // Copies keep the end time
+    Deadline e(0.05);
+    Deadline f = e;
+    utils__sleep_msecs(100);
+    ASSERT(f.expired_now());
+    return true;
+}
+
 bool UtilsTester::in_cont_in_set() const {
     // Setup
     set<int> s1={0,3,4,6,2};    // Will be sorted
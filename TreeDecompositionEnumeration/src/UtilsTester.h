@@ -23,6 +23,7 @@ namespace tdenum {
     X(to_str) \
     X(substr_functions) \
     X(time_functions) \
+    X(deadline) \
     X(in_cont_in_set) \
     X(same_vector_elements) \
     X(remove_vec) \